@@ -0,0 +1,268 @@
+// Microbenchmarks for the per-keystroke path of the grid and for the strategy solver.
+// The grid benchmarks drive the same model code that SudokuGridWidget runs,
+// without a widget, so background puzzle generation doesn't skew the numbers.
+//
+// The `bench` target writes the results to sudoku-bench.json in the build directory.
+
+#include "brute_force.h"
+#include "candidate_engine.h"
+#include "cell_state.h"
+#include "ffi_handles.h"
+#include "native_solver.h"
+#include "puzzle_format.h"
+#include "strategies.h"
+#include "sudoku_helper.h"
+#include "undo_journal.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace {
+    // fixed corpus, from easy to hard
+    const char* const CORPUS[] = {
+        "003020600900305001001806400008102900700000008006708200002609500800203009005010300",
+        "200080300060070084030500209000105408000000000402706000301007040720040060004010003",
+        "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+        "52...6.........7.13...........4..8..6......5...........418.........3..2...87.....",
+        "85...24..72......9..4.........1.7..23.5...9...4...........8..7..17..........36.4.",
+    };
+
+    auto initial_state(const char* puzzle) -> GridWidgetState {
+        auto sudoku = parse_puzzle(puzzle).value();
+        GridWidgetState state;
+        for (int cell = 0; cell < 81; cell++) {
+            auto digit = sudoku._0[cell];
+            state[cell] = digit != 0 ? CellWidgetState::clue(digit) : CellWidgetState::from_candidates(0x1FF);
+        }
+        CandidateEngine engine;
+        engine.reset(state);
+        engine.restrict_candidates(state);
+        return state;
+    }
+
+    // the empty cells of a state and the lowest candidate of each
+    auto moves(const GridWidgetState& state) -> std::vector<Candidate> {
+        std::vector<Candidate> moves;
+        for (uint8_t cell = 0; cell < 81; cell++) {
+            auto mask = state[cell].candidate_mask();
+            if (mask != 0) {
+                moves.push_back(Candidate{ .cell = cell, .num = static_cast<uint8_t>(__builtin_ctz(mask) + 1) });
+            }
+        }
+        return moves;
+    }
+
+    // what SudokuGridWidget::insert_candidate does
+    auto insert_candidate(UndoJournal& journal, CandidateEngine& engine, Candidate candidate) -> void {
+        if (!journal.state()[candidate.cell].is_candidates()) {
+            return;
+        }
+        journal.set_cell(candidate.cell, CellWidgetState::entry(candidate.num));
+        engine.place(candidate.cell, candidate.num);
+        for (auto peer : CandidateEngine::peers(candidate.cell)) {
+            journal.set_cell(peer, journal.state()[peer].with_candidate(candidate.num, false));
+        }
+        journal.commit();
+    }
+}
+
+// to_grid_state(), converting a whole grid for the FFI. The grid itself keeps a converted copy up to date.
+static void BM_grid_state(benchmark::State& bench) {
+    auto state = initial_state(CORPUS[2]);
+    for (auto _ : bench) {
+        auto grid_state = to_grid_state(state);
+        benchmark::DoNotOptimize(grid_state);
+    }
+}
+BENCHMARK(BM_grid_state);
+
+// SudokuGridWidget::start_sudoku(), rebuilding the house masks and stripping the conflicting candidates
+static void BM_recompute_candidates(benchmark::State& bench) {
+    auto state = initial_state(CORPUS[2]);
+    CandidateEngine engine;
+    for (auto _ : bench) {
+        engine.reset(state);
+        engine.restrict_candidates(state);
+        benchmark::DoNotOptimize(state);
+    }
+}
+BENCHMARK(BM_recompute_candidates);
+
+// SudokuGridWidget::set_candidate(), i.e. one pencil mark toggle and push_savepoint()
+// The journal starts over after a long game's worth of steps, so its growth doesn't dominate.
+static void BM_push_savepoint(benchmark::State& bench) {
+    const size_t STEPS_PER_GAME = 1000;
+    auto initial = initial_state(CORPUS[2]);
+    UndoJournal journal;
+    journal.reset(initial);
+    auto cells = moves(journal.state());
+
+    size_t i = 0;
+    for (auto _ : bench) {
+        if (i % STEPS_PER_GAME == 0) {
+            bench.PauseTiming();
+            journal.reset(initial);
+            bench.ResumeTiming();
+        }
+        auto move = cells[i++ % cells.size()];
+        auto cell_state = journal.state()[move.cell];
+        bool is_possible = cell_state.candidates()[move.num - 1];
+        journal.set_cell(move.cell, cell_state.with_candidate(move.num, !is_possible));
+        journal.commit();
+    }
+}
+BENCHMARK(BM_push_savepoint);
+
+// SudokuGridWidget::insert_candidate(), entering a digit and striking it from the peers
+static void BM_insert_candidate(benchmark::State& bench) {
+    auto initial = initial_state(CORPUS[2]);
+    auto candidates = moves(initial);
+    UndoJournal journal;
+    CandidateEngine engine;
+
+    for (auto _ : bench) {
+        bench.PauseTiming();
+        journal.reset(initial);
+        engine.reset(initial);
+        bench.ResumeTiming();
+
+        for (auto candidate : candidates) {
+            insert_candidate(journal, engine, candidate);
+        }
+    }
+    bench.SetItemsProcessed(bench.iterations() * candidates.size());
+}
+BENCHMARK(BM_insert_candidate);
+
+// SudokuGridWidget::undo() and redo() over a full game's worth of entries
+static void BM_undo_redo(benchmark::State& bench) {
+    auto initial = initial_state(CORPUS[2]);
+    UndoJournal journal;
+    CandidateEngine engine;
+    journal.reset(initial);
+    engine.reset(initial);
+    for (auto candidate : moves(initial)) {
+        insert_candidate(journal, engine, candidate);
+    }
+
+    auto replay = [&](const CellDelta& delta) { engine.update_cell(delta.cell, delta.old_state, delta.new_state); };
+    for (auto _ : bench) {
+        while (journal.undo(replay)) {
+        }
+        while (journal.redo(replay)) {
+        }
+    }
+    bench.SetItemsProcessed(bench.iterations() * (journal.n_nodes() - 1) * 2);
+}
+BENCHMARK(BM_undo_redo);
+
+// UndoJournal::go_to() between the ends of two lines of play that split at the start,
+// what switching branches costs at the end of a game
+static void BM_switch_branch(benchmark::State& bench) {
+    auto initial = initial_state(CORPUS[2]);
+    auto candidates = moves(initial);
+    UndoJournal journal;
+    CandidateEngine engine;
+    journal.reset(initial);
+    engine.reset(initial);
+
+    auto replay = [&](const CellDelta& delta) { engine.update_cell(delta.cell, delta.old_state, delta.new_state); };
+    for (auto candidate : candidates) {
+        insert_candidate(journal, engine, candidate);
+    }
+    std::array<uint32_t, 2> ends = { journal.node(), 0 };
+    while (journal.undo(replay)) {
+    }
+    for (auto candidate = candidates.rbegin(); candidate != candidates.rend(); candidate++) {
+        insert_candidate(journal, engine, *candidate);
+    }
+    ends[1] = journal.node();
+
+    size_t i = 0;
+    for (auto _ : bench) {
+        journal.go_to(ends[i++ % 2], replay);
+    }
+    bench.counters["nodes"] = journal.n_nodes();
+}
+BENCHMARK(BM_switch_branch);
+
+// solving with the first n strategies on the whole corpus
+// so each additional strategy's cost shows up as a step
+static void BM_strategy_solve(benchmark::State& bench) {
+    auto n_strategies = static_cast<size_t>(bench.range(0));
+    std::vector<GridState> grid_states;
+    for (auto* puzzle : CORPUS) {
+        grid_states.push_back(to_grid_state(initial_state(puzzle)));
+    }
+
+    for (auto _ : bench) {
+        for (const auto& grid_state : grid_states) {
+            auto results = SolverHandle(grid_state).solve(std::span(STRATEGIES.data(), n_strategies));
+            benchmark::DoNotOptimize(results);
+        }
+    }
+    bench.SetLabel(strategy_name(STRATEGIES[n_strategies - 1]));
+    bench.SetItemsProcessed(bench.iterations() * grid_states.size());
+}
+BENCHMARK(BM_strategy_solve)->DenseRange(1, N_GRADES);
+
+// the same for the strategies that native_hint handles on its own
+static void BM_native_hint(benchmark::State& bench) {
+    auto n_strategies = static_cast<size_t>(bench.range(0));
+    std::vector<GridState> grid_states;
+    for (auto* puzzle : CORPUS) {
+        grid_states.push_back(to_grid_state(initial_state(puzzle)));
+    }
+
+    for (auto _ : bench) {
+        for (const auto& grid_state : grid_states) {
+            auto result = native_hint(grid_state, std::span(STRATEGIES.data(), n_strategies));
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    bench.SetLabel(strategy_name(STRATEGIES[n_strategies - 1]));
+    bench.SetItemsProcessed(bench.iterations() * grid_states.size());
+}
+BENCHMARK(BM_native_hint)->DenseRange(1, 3);
+
+// solution and uniqueness check, as done for every new puzzle
+static void BM_unique_solution(benchmark::State& bench) {
+    auto sudoku = parse_puzzle(CORPUS[bench.range(0)]).value();
+    for (auto _ : bench) {
+        benchmark::DoNotOptimize(unique_solution(sudoku));
+    }
+}
+BENCHMARK(BM_unique_solution)->DenseRange(0, std::size(CORPUS) - 1);
+
+// sudoku_helper.h
+static void BM_cell_at_position(benchmark::State& bench) {
+    for (auto _ : bench) {
+        for (int house = 0; house < 27; house++) {
+            for (int position = 0; position < 9; position++) {
+                benchmark::DoNotOptimize(cell_at_position(house, position));
+            }
+        }
+    }
+}
+BENCHMARK(BM_cell_at_position);
+
+static void BM_block_of_miniline(benchmark::State& bench) {
+    for (auto _ : bench) {
+        for (int miniline = 0; miniline < 54; miniline++) {
+            benchmark::DoNotOptimize(block_of_miniline(miniline));
+        }
+    }
+}
+BENCHMARK(BM_block_of_miniline);
+
+static void BM_foreach_cell_in_house(benchmark::State& bench) {
+    for (auto _ : bench) {
+        int sum = 0;
+        for (int house = 0; house < 27; house++) {
+            foreach_cell_in_house(house, [&](int cell) { sum += cell; });
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(BM_foreach_cell_in_house);
+
+BENCHMARK_MAIN();
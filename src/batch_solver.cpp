@@ -0,0 +1,190 @@
+// Headless solver for puzzle collections, one puzzle per line.
+//
+//   sudoku-batch [FILE...]
+//
+// Reads the files (memory-mapped) or stdin, runs every puzzle through the same
+// strategy solver the GUI uses and prints one line per puzzle, in input order:
+//
+//   <grade> <deductions> <solution>
+//
+// The grade is the index of the hardest strategy needed (see strategies.h), or - if the
+// strategies don't suffice. The solution has . where the strategies got stuck.
+// Invalid lines produce "invalid". Throughput is reported on stderr.
+
+#include "grading.h"
+#include "mapped_file.h"
+#include "puzzle_format.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+    const size_t BATCH_SIZE = 256;
+
+    struct Batch {
+        // only used for stdin, mapped files are referenced directly
+        std::vector<std::string> owned_lines;
+        std::vector<std::string_view> lines;
+        std::string output;
+        std::promise<void> done;
+    };
+
+    auto solve_line(std::string_view line, std::string& output) -> void {
+        auto sudoku = parse_puzzle(line);
+        if (!sudoku.has_value()) {
+            output += "invalid\n";
+            return;
+        }
+
+        auto outcome = solve_with_strategies(*sudoku, STRATEGIES);
+        if (outcome.is_solved) {
+            output += std::to_string(grade_solvable_sudoku(*sudoku));
+        } else {
+            output += '-';
+        }
+        output += ' ';
+        output += std::to_string(outcome.n_deductions);
+        output += ' ';
+        output += format_puzzle(outcome.digits);
+        output += '\n';
+    }
+
+    // Solves batches in parallel and writes their results in submission order.
+    class OrderedSolver {
+        WorkStealingPool m_pool;
+        // in submission order
+        std::deque<std::unique_ptr<Batch>> m_in_flight;
+        size_t m_max_in_flight;
+        size_t m_n_puzzles = 0;
+
+        auto write_oldest() -> void {
+            auto& batch = *m_in_flight.front();
+            batch.done.get_future().wait();
+            std::fwrite(batch.output.data(), 1, batch.output.size(), stdout);
+            m_in_flight.pop_front();
+        }
+
+    public:
+        explicit OrderedSolver(unsigned n_threads) : m_pool(n_threads), m_max_in_flight(4 * n_threads) {}
+
+        auto submit(std::unique_ptr<Batch> batch) -> void {
+            if (batch->lines.empty()) {
+                return;
+            }
+            m_n_puzzles += batch->lines.size();
+
+            auto* raw = batch.get();
+            m_in_flight.push_back(std::move(batch));
+            m_pool.submit([raw]() {
+                for (auto line : raw->lines) {
+                    solve_line(line, raw->output);
+                }
+                raw->done.set_value();
+            });
+
+            while (m_in_flight.size() > m_max_in_flight) {
+                this->write_oldest();
+            }
+        }
+
+        // Wait for and write all outstanding batches.
+        auto flush() -> void {
+            while (!m_in_flight.empty()) {
+                this->write_oldest();
+            }
+        }
+
+        auto n_puzzles() const -> size_t {
+            return m_n_puzzles;
+        }
+    };
+
+    auto solve_mapped(OrderedSolver& solver, const std::string& path) -> void {
+        MappedFile file(path);
+
+        auto batch = std::make_unique<Batch>();
+        foreach_line(file.view(), [&](std::string_view line) {
+            if (line.empty()) {
+                return;
+            }
+            batch->lines.push_back(line);
+            if (batch->lines.size() == BATCH_SIZE) {
+                solver.submit(std::move(batch));
+                batch = std::make_unique<Batch>();
+            }
+        });
+        solver.submit(std::move(batch));
+
+        // the batches point into the mapping
+        solver.flush();
+    }
+
+    auto solve_stdin(OrderedSolver& solver) -> void {
+        auto submit = [&](std::unique_ptr<Batch> batch) {
+            // the strings don't move anymore once the batch is complete
+            for (const auto& line : batch->owned_lines) {
+                batch->lines.push_back(line);
+            }
+            solver.submit(std::move(batch));
+        };
+
+        auto batch = std::make_unique<Batch>();
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                continue;
+            }
+            batch->owned_lines.push_back(std::move(line));
+            if (batch->owned_lines.size() == BATCH_SIZE) {
+                submit(std::move(batch));
+                batch = std::make_unique<Batch>();
+            }
+        }
+        submit(std::move(batch));
+        solver.flush();
+    }
+}
+
+auto main(int argc, char* argv[]) -> int {
+    std::ios::sync_with_stdio(false);
+
+    auto n_threads = std::max(1u, std::thread::hardware_concurrency());
+    OrderedSolver solver(n_threads);
+
+    auto start = std::chrono::steady_clock::now();
+    try {
+        if (argc < 2) {
+            solve_stdin(solver);
+        }
+        for (int i = 1; i < argc; i++) {
+            solve_mapped(solver, argv[i]);
+        }
+    } catch (const std::system_error& error) {
+        solver.flush();
+        std::fprintf(stderr, "%s: %s\n", argv[0], error.what());
+        return EXIT_FAILURE;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::fflush(stdout);
+    std::fprintf(
+        stderr,
+        "%zu puzzles in %.3f s, %.0f puzzles/s on %u threads\n",
+        solver.n_puzzles(),
+        elapsed.count(),
+        solver.n_puzzles() / std::max(elapsed.count(), 1e-9),
+        n_threads);
+    return EXIT_SUCCESS;
+}
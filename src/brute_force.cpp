@@ -0,0 +1,185 @@
+#include "brute_force.h"
+#include "sudoku_tables.h"
+#include <algorithm>
+#include <iterator>
+
+#if defined(SUDOKU_DLX)
+#    include "dancing_links.h"
+#endif
+
+namespace {
+    constexpr auto ALL_CELLS = CellSet(~uint64_t(0), (uint64_t(1) << 17) - 1);
+
+    // one board per digit, indexed by digit - 1
+    struct Board {
+        // where the digit can still go, solved cells are in none of them
+        std::array<CellSet, 9> possible;
+        // where the digit is placed
+        std::array<CellSet, 9> placed{};
+        CellSet unsolved = ALL_CELLS;
+        Digits digits{};
+
+        Board() {
+            possible.fill(ALL_CELLS);
+        }
+
+        // false if `digit` can't go into `cell`
+        auto place(int cell, uint8_t digit) -> bool {
+            if (!possible[digit - 1].contains(cell)) {
+                return false;
+            }
+            auto cell_set = CellSet::single(cell);
+            for (auto& board : possible) {
+                board = board.without(cell_set);
+            }
+            possible[digit - 1] = possible[digit - 1].without(PEER_MASKS[cell]);
+            placed[digit - 1] = placed[digit - 1] | cell_set;
+            unsolved = unsolved.without(cell_set);
+            digits[cell] = digit;
+            return true;
+        }
+    };
+
+    // unsolved cells by how many candidates they have left, with bit sliced counters
+    struct CandidateCounts {
+        CellSet at_least_one;
+        CellSet at_least_two;
+        CellSet at_least_three;
+    };
+
+    auto count_candidates(const Board& board) -> CandidateCounts {
+        CandidateCounts counts;
+        for (const auto& possible : board.possible) {
+            counts.at_least_three = counts.at_least_three | (counts.at_least_two & possible);
+            counts.at_least_two = counts.at_least_two | (counts.at_least_one & possible);
+            counts.at_least_one = counts.at_least_one | possible;
+        }
+        return counts;
+    }
+
+    enum class Progress { Placed, Stuck, Contradiction };
+
+    // Fill in all naked singles or, if there are none, the hidden singles.
+    auto fill_singles(Board& board) -> Progress {
+        auto counts = count_candidates(board);
+        if (!board.unsolved.without(counts.at_least_one).is_empty()) {
+            return Progress::Contradiction;
+        }
+
+        auto naked_singles = counts.at_least_one.without(counts.at_least_two);
+        if (!naked_singles.is_empty()) {
+            auto is_consistent = true;
+            naked_singles.foreach([&](int cell) {
+                // may have been taken away by an earlier single of the same round
+                for (uint8_t digit = 1; digit <= 9; digit++) {
+                    if (board.possible[digit - 1].contains(cell)) {
+                        board.place(cell, digit);
+                        return;
+                    }
+                }
+                is_consistent = false;
+            });
+            return is_consistent ? Progress::Placed : Progress::Contradiction;
+        }
+
+        auto progress = Progress::Stuck;
+        for (uint8_t digit = 1; digit <= 9; digit++) {
+            if (board.placed[digit - 1].count() == 9) {
+                continue;
+            }
+            for (int house = 0; house < 27; house++) {
+                auto positions = board.possible[digit - 1] & HOUSE_MASKS[house];
+                if (positions.is_empty()) {
+                    if ((board.placed[digit - 1] & HOUSE_MASKS[house]).is_empty()) {
+                        return Progress::Contradiction;
+                    }
+                } else if (positions.count() == 1) {
+                    positions.foreach([&](int cell) { board.place(cell, digit); });
+                    progress = Progress::Placed;
+                }
+            }
+        }
+        return progress;
+    }
+
+    // a cell with two candidates if there is one, so that a wrong guess is noticed early
+    auto branch_cell(const Board& board) -> int {
+        auto counts = count_candidates(board);
+        auto pairs = counts.at_least_two.without(counts.at_least_three);
+        auto cell = -1;
+        (pairs.is_empty() ? board.unsolved : pairs).foreach([&](int candidate) {
+            if (cell < 0) {
+                cell = candidate;
+            }
+        });
+        return cell;
+    }
+
+    // The board is passed by value, each guess gets a copy on the stack.
+    auto search(Board board, uint8_t limit, SolutionCount& count) -> void {
+        while (!board.unsolved.is_empty()) {
+            auto progress = fill_singles(board);
+            if (progress == Progress::Contradiction) {
+                return;
+            }
+            if (progress == Progress::Stuck) {
+                break;
+            }
+        }
+
+        if (board.unsolved.is_empty()) {
+            if (count.n_solutions == 0) {
+                count.solution = board.digits;
+            }
+            count.n_solutions++;
+            return;
+        }
+
+        auto cell = branch_cell(board);
+        for (uint8_t digit = 1; digit <= 9 && count.n_solutions < limit; digit++) {
+            if (board.possible[digit - 1].contains(cell)) {
+                auto guess = board;
+                guess.place(cell, digit);
+                search(guess, limit, count);
+            }
+        }
+    }
+}
+
+auto count_solutions(const Digits& digits, uint8_t limit) -> SolutionCount {
+#if defined(SUDOKU_DLX)
+    return dancing_links_count_solutions(digits, limit);
+#else
+    SolutionCount count;
+    Board board;
+    for (int cell = 0; cell < 81; cell++) {
+        auto digit = digits[cell];
+        if (digit > 9 || (digit != 0 && !board.place(cell, digit))) {
+            return count;
+        }
+    }
+    if (limit > 0) {
+        search(board, limit, count);
+    }
+    return count;
+#endif
+}
+
+auto count_solutions(const GridWidgetState& state, uint8_t limit) -> SolutionCount {
+    Digits digits;
+    for (int cell = 0; cell < 81; cell++) {
+        digits[cell] = state[cell].digit();
+    }
+    return count_solutions(digits, limit);
+}
+
+auto unique_solution(const Sudoku& sudoku) -> std::optional<Digits> {
+    Digits digits;
+    std::copy(std::begin(sudoku._0), std::end(sudoku._0), digits.begin());
+
+    auto count = count_solutions(digits, 2);
+    if (count.n_solutions != 1) {
+        return {};
+    }
+    return count.solution;
+}
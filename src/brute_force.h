@@ -0,0 +1,33 @@
+#pragma once
+// Backtracking solver for finding the solution of a sudoku and checking that it is unique.
+// Doesn't allocate and takes microseconds, so it can run on the GUI thread.
+//
+// The default backend is a depth-first search over one 81 bit board per digit,
+// filling in naked and hidden singles before every guess.
+// Configuring with -DSUDOKU_DLX=ON switches to Knuth's dancing links instead.
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include "sudoku_ffi/sudoku.h"
+#include "cell_state.h"
+
+// 1-9 for filled cells, 0 for empty ones
+using Digits = std::array<uint8_t, 81>;
+
+struct SolutionCount {
+    // stops counting at the limit
+    uint8_t n_solutions = 0;
+    // the first solution found, all 0 if there is none
+    Digits solution{};
+};
+
+// Count the solutions of the grid given by `digits`, up to `limit`.
+// Digits that conflict with each other make for 0 solutions.
+auto count_solutions(const Digits& digits, uint8_t limit = 2) -> SolutionCount;
+
+// Clues and entries of `state` are kept, candidates are ignored.
+auto count_solutions(const GridWidgetState& state, uint8_t limit = 2) -> SolutionCount;
+
+// Nothing if `sudoku` has no solution or more than one.
+auto unique_solution(const Sudoku& sudoku) -> std::optional<Digits>;
@@ -0,0 +1,132 @@
+#include "candidate_engine.h"
+#include "sudoku_tables.h"
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+auto CandidateEngine::add_to_houses(uint8_t cell, uint8_t digit) -> void {
+    for (auto house : HOUSES_OF_CELL[cell]) {
+        m_digit_count[house][digit - 1]++;
+        m_house_digits[house] |= 1u << (digit - 1);
+    }
+}
+
+auto CandidateEngine::remove_from_houses(uint8_t cell, uint8_t digit) -> void {
+    for (auto house : HOUSES_OF_CELL[cell]) {
+        auto& count = m_digit_count[house][digit - 1];
+        count--;
+        if (count == 0) {
+            m_house_digits[house] &= ~(1u << (digit - 1));
+        }
+    }
+}
+
+auto CandidateEngine::reset(const GridWidgetState& state) -> void {
+    m_digit_count = {};
+    m_house_digits = {};
+
+    for (uint8_t cell = 0; cell < 81; cell++) {
+        auto digit = state[cell].digit();
+        if (digit != 0) {
+            this->add_to_houses(cell, digit);
+        }
+    }
+}
+
+auto CandidateEngine::place(uint8_t cell, uint8_t digit) -> void {
+    this->add_to_houses(cell, digit);
+}
+
+auto CandidateEngine::update_cell(uint8_t cell, const CellWidgetState& old_state, const CellWidgetState& new_state)
+    -> void {
+    auto old_digit = old_state.digit();
+    auto new_digit = new_state.digit();
+    if (old_digit == new_digit) {
+        return;
+    }
+    if (old_digit != 0) {
+        this->remove_from_houses(cell, old_digit);
+    }
+    if (new_digit != 0) {
+        this->add_to_houses(cell, new_digit);
+    }
+}
+
+auto CandidateEngine::peers(uint8_t cell) -> const std::array<uint8_t, 20>& {
+    return PEERS[cell];
+}
+
+auto CandidateEngine::allowed_mask(uint8_t cell) const -> uint16_t {
+    auto [row, col, block] = HOUSES_OF_CELL[cell];
+    auto taken = m_house_digits[row] | m_house_digits[col] | m_house_digits[block];
+    return ~taken & 0x1FF;
+}
+
+#if defined(__SSE2__)
+namespace {
+    // The digits taken from the first 8 cells of `row`. Their columns are 8 consecutive houses
+    // and their blocks repeat for every row of a band, so it's two ORs instead of 24 lookups.
+    // The last cell of the row is left to the caller, 9 cells don't fit a vector.
+    auto taken_in_row(const std::array<uint16_t, 27>& house_digits, int row) -> __m128i {
+        auto block = 18 + row / 3 * 3;
+        auto blocks = _mm_setr_epi16(
+            static_cast<int16_t>(house_digits[block]),
+            static_cast<int16_t>(house_digits[block]),
+            static_cast<int16_t>(house_digits[block]),
+            static_cast<int16_t>(house_digits[block + 1]),
+            static_cast<int16_t>(house_digits[block + 1]),
+            static_cast<int16_t>(house_digits[block + 1]),
+            static_cast<int16_t>(house_digits[block + 2]),
+            static_cast<int16_t>(house_digits[block + 2]));
+        auto columns = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&house_digits[9]));
+        auto rows = _mm_set1_epi16(static_cast<int16_t>(house_digits[row]));
+        return _mm_or_si128(rows, _mm_or_si128(columns, blocks));
+    }
+}
+#endif
+
+auto CandidateEngine::allowed_masks(Candidates& masks) const -> void {
+#if defined(__SSE2__)
+    auto all_digits = _mm_set1_epi16(0x1FF);
+    for (int row = 0; row < 9; row++) {
+        auto allowed = _mm_andnot_si128(taken_in_row(m_house_digits, row), all_digits);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&masks[row * 9]), allowed);
+        masks[row * 9 + 8] = this->allowed_mask(row * 9 + 8);
+    }
+#else
+    for (uint8_t cell = 0; cell < 81; cell++) {
+        masks[cell] = this->allowed_mask(cell);
+    }
+#endif
+}
+
+// Filled cells keep their digit and flags, only the candidate bits are masked.
+// The cells are copied to plain lanes rather than aliased, CellWidgetState is a class and not a uint16_t.
+auto CandidateEngine::restrict_candidates(GridWidgetState& state) const -> void {
+    constexpr uint16_t KEEP_FILLED = static_cast<uint16_t>(~0x1FF);
+
+    Candidates masks;
+    this->allowed_masks(masks);
+    Candidates cells;
+    for (int cell = 0; cell < 81; cell++) {
+        cells[cell] = state[cell].bits();
+    }
+
+    int i = 0;
+#if defined(__SSE2__)
+    auto keep_filled = _mm_set1_epi16(static_cast<int16_t>(KEEP_FILLED));
+    for (; i + 8 <= 81; i += 8) {
+        auto* lanes = reinterpret_cast<__m128i*>(&cells[i]);
+        auto mask = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&masks[i])), keep_filled);
+        _mm_storeu_si128(lanes, _mm_and_si128(_mm_loadu_si128(lanes), mask));
+    }
+#endif
+    for (; i < 81; i++) {
+        cells[i] &= masks[i] | KEEP_FILLED;
+    }
+
+    for (int cell = 0; cell < 81; cell++) {
+        state[cell] = CellWidgetState::from_bits(cells[cell]);
+    }
+}
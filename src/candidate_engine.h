@@ -0,0 +1,43 @@
+#pragma once
+// Keeps track of which digits are placed in each row, column and block
+// so that candidates can be eliminated without asking the solver.
+// Entering a digit only touches the 20 peers of its cell.
+
+#include <array>
+#include <cstdint>
+#include "cell_state.h"
+
+class CandidateEngine {
+    // how often a digit occurs in each house, indexed [house][digit - 1]
+    // counts instead of bits because entries may conflict with each other
+    std::array<std::array<uint8_t, 9>, 27> m_digit_count{};
+
+    // bit n is set if digit n+1 occurs at least once in the house
+    std::array<uint16_t, 27> m_house_digits{};
+
+    auto add_to_houses(uint8_t cell, uint8_t digit) -> void;
+    auto remove_from_houses(uint8_t cell, uint8_t digit) -> void;
+    auto allowed_mask(uint8_t cell) const -> uint16_t;
+
+public:
+    // rebuild all house masks from scratch
+    auto reset(const GridWidgetState& state) -> void;
+
+    // Record `digit` in the houses of `cell`.
+    // Striking it from the candidates of the peers is up to the caller, see `peers`.
+    auto place(uint8_t cell, uint8_t digit) -> void;
+
+    // Update the house masks for a cell that changed from `old_state` to `new_state`.
+    // Used when replaying undo/redo deltas.
+    auto update_cell(uint8_t cell, const CellWidgetState& old_state, const CellWidgetState& new_state) -> void;
+
+    // the 20 cells that share a row, column or block with `cell`
+    static auto peers(uint8_t cell) -> const std::array<uint8_t, 20>&;
+
+    // For every cell, the candidates that don't conflict with any digit in its houses.
+    // Works a row at a time with SSE2, 8 of its cells at once.
+    auto allowed_masks(Candidates& masks) const -> void;
+
+    // Remove all conflicting candidates from every unfilled cell.
+    auto restrict_candidates(GridWidgetState& state) const -> void;
+};
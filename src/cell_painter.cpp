@@ -0,0 +1,245 @@
+#include "cell_painter.h"
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+#include <QFontDatabase>
+#include <QPen>
+#include <QPixmap>
+#include <algorithm>
+#include <QString>
+
+namespace {
+    const QColor FG_DEFAULT = QColor(0, 0, 0);                       // black
+    const QColor FG_NONCLUE_ENTRY = QColor(110, 110, 110);           // grey
+    const QColor FG_MISTAKE = QColor(200, 20, 20);                   // dark red
+    const QColor BG_DEFAULT = QColor(255, 255, 255);                 // white
+    const QColor BG_FOCUSED = QColor(172, 172, 255);                 // light blue
+    const QColor BG_HIGHLIGHTED = QColor(255, 153, 153);             // light red
+    const QColor BG_HIGHLIGHTED_HINT_WEAK = QColor(217, 217, 217);   // light grey
+    const QColor BG_HIGHLIGHTED_HINT_STRONG = QColor(140, 140, 140); // strong grey
+    const QColor DIGIT_HIGHLIGHTED = QColor(15, 225, 15);            // green
+    const QColor DIGIT_HIGHLIGHTED_CONFLICT = QColor(225, 15, 15);   // red
+
+    auto fg_color(DigitStyle style) -> QColor {
+        switch (style) {
+            case DigitStyle::Clue:
+                return FG_DEFAULT;
+            case DigitStyle::Entry:
+                return FG_NONCLUE_ENTRY;
+            case DigitStyle::Mistake:
+                return FG_MISTAKE;
+        }
+        return FG_DEFAULT;
+    }
+
+    auto digit_style(const CellAppearance& appearance) -> DigitStyle {
+        if (appearance.state.is_clue()) {
+            return DigitStyle::Clue;
+        }
+        return appearance.is_mistake ? DigitStyle::Mistake : DigitStyle::Entry;
+    }
+
+    auto bg_color(const CellAppearance& appearance) -> QColor {
+        if (appearance.in_hint_mode) {
+            switch (appearance.hint_highlight) {
+                case HintHighlight::Strong:
+                    return BG_HIGHLIGHTED_HINT_STRONG;
+                case HintHighlight::Weak:
+                    return BG_HIGHLIGHTED_HINT_WEAK;
+                case HintHighlight::None:
+                    return BG_DEFAULT;
+            }
+        }
+
+        if (appearance.has_focus) {
+            return BG_FOCUSED;
+        }
+
+        if (appearance.contains_highlighted_digit) {
+            return BG_HIGHLIGHTED;
+        }
+        return BG_DEFAULT;
+    }
+
+    auto bg_color_inner(const CellAppearance& appearance) -> QColor {
+        if (appearance.in_hint_mode) {
+            return bg_color(appearance);
+        }
+
+        if (appearance.contains_highlighted_digit) {
+            return BG_HIGHLIGHTED;
+        }
+        if (appearance.has_focus) {
+            return BG_FOCUSED;
+        }
+        return BG_DEFAULT;
+    }
+
+    // size of a cell's font for its digit and for the pencil marks
+    auto digit_font(int cell_size) -> QFont {
+        auto font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+        font.setPixelSize(cell_size * 5 / 6);
+        return font;
+    }
+
+    auto pencil_mark_font(int cell_size) -> QFont {
+        auto font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+        font.setPixelSize(cell_size / 4);
+        return font;
+    }
+
+    // distance between the centers of neighbouring pencil marks
+    auto pencil_mark_spacing(int cell_size) -> int {
+        return cell_size * 1.25 / 4;
+    }
+
+    auto transparent_pixmap(int size, qreal pixel_ratio) -> QPixmap {
+        QPixmap pixmap(QSize(size, size) * pixel_ratio);
+        pixmap.setDevicePixelRatio(pixel_ratio);
+        pixmap.fill(Qt::transparent);
+        return pixmap;
+    }
+}
+
+Glyphs::Glyphs(int cell_size, qreal pixel_ratio) : m_cell_size(cell_size), m_pixel_ratio(pixel_ratio) {
+    auto size = std::max(cell_size, 1);
+
+    auto render_digit = [&](uint8_t digit, const QColor& color) {
+        auto pixmap = transparent_pixmap(size, pixel_ratio);
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(color);
+        painter.setFont(digit_font(size));
+        painter.drawText(QRect(0, 0, size, size), Qt::AlignCenter, QString::number(digit));
+        return pixmap;
+    };
+
+    auto mark_size = std::max(pencil_mark_spacing(size), 1);
+    auto radius = size * 9 / 64; // a bit more than 1/4 / 2, the size of the font
+    auto render_pencil_mark = [&](uint8_t digit, MarkHighlight highlight) {
+        auto pixmap = transparent_pixmap(mark_size, pixel_ratio);
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::Antialiasing);
+
+        if (highlight != MarkHighlight::None) {
+            auto color = highlight == MarkHighlight::Conflict ? DIGIT_HIGHLIGHTED_CONFLICT : DIGIT_HIGHLIGHTED;
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(QBrush(color));
+            painter.drawEllipse(QPointF(mark_size / 2.0, mark_size / 2.0), radius, radius);
+        }
+        painter.setPen(FG_DEFAULT);
+        painter.setFont(pencil_mark_font(size));
+        painter.drawText(QRect(0, 0, mark_size, mark_size), Qt::AlignCenter, QString::number(digit));
+        return pixmap;
+    };
+
+    for (uint8_t digit = 1; digit <= 9; digit++) {
+        for (auto style : { DigitStyle::Clue, DigitStyle::Entry, DigitStyle::Mistake }) {
+            m_digits[static_cast<int>(style)][digit - 1] = render_digit(digit, fg_color(style));
+        }
+        for (auto highlight : { MarkHighlight::None, MarkHighlight::Regular, MarkHighlight::Conflict }) {
+            m_pencil_marks[static_cast<int>(highlight)][digit - 1] = render_pencil_mark(digit, highlight);
+        }
+    }
+}
+
+auto Glyphs::cell_size() const -> int {
+    return m_cell_size;
+}
+
+auto Glyphs::pixel_ratio() const -> qreal {
+    return m_pixel_ratio;
+}
+
+auto Glyphs::digit(uint8_t digit, DigitStyle style) const -> const QPixmap& {
+    return m_digits[static_cast<int>(style)][digit - 1];
+}
+
+auto Glyphs::pencil_mark(uint8_t digit, MarkHighlight highlight) const -> const QPixmap& {
+    return m_pencil_marks[static_cast<int>(highlight)][digit - 1];
+}
+
+// Rasterizes the glyphs if the size wasn't painted recently.
+auto GlyphAtlas::glyphs(int cell_size, qreal pixel_ratio) -> const Glyphs& {
+    auto entry = std::find_if(m_glyphs.begin(), m_glyphs.end(), [&](const Glyphs& glyphs) {
+        return glyphs.cell_size() == cell_size && glyphs.pixel_ratio() == pixel_ratio;
+    });
+    if (entry != m_glyphs.end()) {
+        // mark as most recently used
+        std::rotate(entry, entry + 1, m_glyphs.end());
+        return m_glyphs.back();
+    }
+
+    if (m_glyphs.size() == CAPACITY) {
+        m_glyphs.pop_front();
+    }
+    return m_glyphs.emplace_back(cell_size, pixel_ratio);
+}
+
+auto paint_cell(
+    QPainter& painter,
+    const QRect& rect,
+    const CellAppearance& appearance,
+    GlyphAtlas& atlas,
+    FrameProfiler& profiler) -> void {
+    painter.save();
+    // paint in cell coordinates
+    painter.translate(rect.topLeft());
+    auto size = rect.width(); // cell is quadratic
+    auto cell_rect = QRect(0, 0, size, size);
+
+    // draw background
+    auto bg = bg_color(appearance);
+    painter.setPen(QPen());
+    painter.setBrush(QBrush(bg));
+    painter.drawRect(cell_rect);
+
+    // draw inner, rounded square over background
+    // if multiple highlights exist on a cell
+    // do so conditionally because there is a black 1px border
+    // drawn around it
+    auto bg_inner = bg_color_inner(appearance);
+    if (bg != bg_inner) {
+        painter.setBrush(QBrush(bg_inner));
+        auto ring_width = size / 12;
+        auto low = ring_width;
+        auto high = size - 2 * low;
+        painter.drawRoundedRect(QRect(low, low, high, high), 25, 25, Qt::SizeMode::RelativeSize);
+    }
+
+    const auto& glyphs = atlas.glyphs(size, painter.device()->devicePixelRatioF());
+    ScopedProfile profile(profiler, ProfileEvent::Digits);
+
+    auto digit = appearance.state.digit();
+    if (digit != 0) {
+        painter.drawPixmap(0, 0, glyphs.digit(digit, digit_style(appearance)));
+    } else {
+        // pencil marks in a 3x3 grid around the center
+        auto candidates = appearance.state.candidates();
+        auto spacing = pencil_mark_spacing(size);
+        auto mark_size = std::max(spacing, 1);
+        auto center = QPoint(size / 2, size / 2);
+
+        for (int digit = 0; digit < 9; digit++) {
+            if (!candidates[digit]) {
+                continue;
+            }
+
+            // strategy results don't always contain the full list of candidates
+            // only 2 sets of some position and some digits
+            // the check above makes sure we don't highlight empty places
+            auto bit = 1u << digit;
+            auto highlight = MarkHighlight::None;
+            if (appearance.conflict_highlights & bit) {
+                highlight = MarkHighlight::Conflict;
+            } else if (appearance.digit_highlights & bit) {
+                highlight = MarkHighlight::Regular;
+            }
+
+            auto mark_center = center + QPoint((digit % 3 - 1) * spacing, (digit / 3 - 1) * spacing);
+            auto mark_corner = QPointF(mark_center) - QPointF(mark_size / 2.0, mark_size / 2.0);
+            painter.drawPixmap(mark_corner, glyphs.pencil_mark(digit + 1, highlight));
+        }
+    }
+    painter.restore();
+}
@@ -0,0 +1,79 @@
+#pragma once
+// Painting of a single cell, shared by the cell widgets and the single widget grid renderer.
+
+#include <QPainter>
+#include <QPixmap>
+#include <QRect>
+#include <array>
+#include <deque>
+#include <cstdint>
+#include "cell_state.h"
+#include "hint_highlight.h"
+#include "frame_profiler.h"
+
+// everything that determines what a cell looks like
+struct CellAppearance {
+    CellWidgetState state;
+    bool has_focus = false;
+    // the cell has the digit highlighted in the main window as a candidate
+    bool contains_highlighted_digit = false;
+    // an entry that contradicts the solution
+    bool is_mistake = false;
+
+    bool in_hint_mode = false;
+    HintHighlight hint_highlight = HintHighlight::None;
+    // bit n is set if candidate n+1 is part of the hint's pattern
+    uint16_t digit_highlights = 0;
+    // bit n is set if candidate n+1 can be removed
+    uint16_t conflict_highlights = 0;
+
+    auto operator==(const CellAppearance&) const -> bool = default;
+};
+
+enum class DigitStyle : uint8_t { Clue, Entry, Mistake };
+enum class MarkHighlight : uint8_t { None, Regular, Conflict };
+
+// Digits and pencil marks pre-rasterized for one cell size, so painting a cell
+// only blits pixmaps instead of laying out text.
+class Glyphs {
+    int m_cell_size;
+    qreal m_pixel_ratio;
+
+    // indexed by style, then digit - 1
+    std::array<std::array<QPixmap, 9>, 3> m_digits;
+    // indexed by highlight, then digit - 1
+    // each includes the highlight circle behind the digit
+    std::array<std::array<QPixmap, 9>, 3> m_pencil_marks;
+
+public:
+    Glyphs(int cell_size, qreal pixel_ratio);
+
+    auto cell_size() const -> int;
+    auto pixel_ratio() const -> qreal;
+
+    // covers the whole cell
+    auto digit(uint8_t digit, DigitStyle style) const -> const QPixmap&;
+    // to be centered on the digit's position in the 3x3 pencil mark grid
+    auto pencil_mark(uint8_t digit, MarkHighlight highlight) const -> const QPixmap&;
+};
+
+// Glyphs of the most recently painted cell sizes.
+// They only change on resize. With the cell widget renderer, the layout
+// may make some cells a pixel larger than others, hence more than one size.
+class GlyphAtlas {
+    static constexpr size_t CAPACITY = 2;
+
+    // least recently used first
+    std::deque<Glyphs> m_glyphs;
+
+public:
+    auto glyphs(int cell_size, qreal pixel_ratio) -> const Glyphs&;
+};
+
+// Paint the cell into `rect`, which must be quadratic.
+auto paint_cell(
+    QPainter& painter,
+    const QRect& rect,
+    const CellAppearance& appearance,
+    GlyphAtlas& atlas,
+    FrameProfiler& profiler) -> void;
@@ -1,21 +1,126 @@
 #pragma once
 
-#include <variant>
+#include <array>
+#include <bit>
 #include <bitset>
 #include <cstdint>
-
-struct Clue {
-    uint8_t digit;
-};
-
-struct Entry {
-    uint8_t digit;
-};
+#include "sudoku_ffi/sudoku.h"
 
 using CellCandidates = std::bitset<9>;
 
-// kind of duplicates CellState, but as a std::variant instead of a tagged union
-// too dangerous to rely on a tagged union everywhere
+// kind of duplicates CellState, but packed into 16 bits instead of a tagged union
 // it also differentiates clues and mere entries
+//
+// bits 0-8:   candidates, bit n for digit n+1, all zero if the cell is filled
+// bits 9-12:  digit, 0 for unfilled cells
+// bit 13:     set if the digit is a clue
 // TODO: find better name
-using CellWidgetState = std::variant<CellCandidates, Clue, Entry>;
+class CellWidgetState {
+    static constexpr uint16_t CANDIDATES_MASK = 0x1FF;
+    static constexpr int DIGIT_SHIFT = 9;
+    static constexpr uint16_t DIGIT_MASK = 0xF << DIGIT_SHIFT;
+    static constexpr uint16_t CLUE_FLAG = 1 << 13;
+
+    uint16_t m_bits = 0;
+
+    constexpr explicit CellWidgetState(uint16_t bits) : m_bits(bits) {}
+
+public:
+    constexpr CellWidgetState() = default;
+
+    static constexpr auto from_candidates(uint16_t candidates) -> CellWidgetState {
+        return CellWidgetState(candidates & CANDIDATES_MASK);
+    }
+
+    static constexpr auto clue(uint8_t digit) -> CellWidgetState {
+        return CellWidgetState(static_cast<uint16_t>(CLUE_FLAG | digit << DIGIT_SHIFT));
+    }
+
+    static constexpr auto entry(uint8_t digit) -> CellWidgetState {
+        return CellWidgetState(static_cast<uint16_t>(digit << DIGIT_SHIFT));
+    }
+
+    // raw bits, for serialization
+    static constexpr auto from_bits(uint16_t bits) -> CellWidgetState {
+        return CellWidgetState(bits);
+    }
+
+    // Whether `bits` are a state the constructors above can make: a digit of at most 9,
+    // no candidates next to a digit, no clue flag without one and nothing in the unused bits.
+    // Bits from outside the program have to pass this before from_bits.
+    static constexpr auto is_valid_bits(uint16_t bits) -> bool {
+        auto digit = (bits & DIGIT_MASK) >> DIGIT_SHIFT;
+        auto is_reserved_clear = (bits & ~(CANDIDATES_MASK | DIGIT_MASK | CLUE_FLAG)) == 0;
+        auto is_clue_filled = (bits & CLUE_FLAG) == 0 || digit != 0;
+        auto is_filled_clear = digit == 0 || (bits & CANDIDATES_MASK) == 0;
+        return is_reserved_clear && digit <= 9 && is_clue_filled && is_filled_clear;
+    }
+
+    constexpr auto bits() const -> uint16_t {
+        return m_bits;
+    }
+
+    // 1-9 for filled cells, 0 otherwise
+    constexpr auto digit() const -> uint8_t {
+        return (m_bits & DIGIT_MASK) >> DIGIT_SHIFT;
+    }
+
+    constexpr auto candidate_mask() const -> uint16_t {
+        return m_bits & CANDIDATES_MASK;
+    }
+
+    constexpr auto candidates() const -> CellCandidates {
+        return CellCandidates(this->candidate_mask());
+    }
+
+    constexpr auto is_candidates() const -> bool {
+        return (m_bits & DIGIT_MASK) == 0;
+    }
+
+    constexpr auto is_clue() const -> bool {
+        return (m_bits & CLUE_FLAG) != 0;
+    }
+
+    constexpr auto is_entry() const -> bool {
+        return !this->is_candidates() && !this->is_clue();
+    }
+
+    // Set or unset a candidate. Filled cells are returned unchanged.
+    constexpr auto with_candidate(uint8_t digit, bool is_possible) const -> CellWidgetState {
+        if (!this->is_candidates()) {
+            return *this;
+        }
+        uint16_t bit = 1u << (digit - 1);
+        return CellWidgetState(is_possible ? m_bits | bit : m_bits & ~bit);
+    }
+
+    constexpr auto operator==(const CellWidgetState&) const -> bool = default;
+};
+
+static_assert(sizeof(CellWidgetState) == 2);
+
+using GridWidgetState = std::array<CellWidgetState, 81>;
+
+// a candidate mask per cell, bit n for digit n+1
+using Candidates = std::array<uint16_t, 81>;
+
+// Convert one cell to the FFI representation. Clues and entries both become digits.
+inline auto to_cell_state(CellWidgetState cell_widget_state) -> CellState {
+    // The digit and the candidates share the start of the union in `CellState`,
+    // so a single 16-bit store fills in whichever one the tag selects.
+    static_assert(std::endian::native == std::endian::little);
+
+    CellState cell_state{};
+    auto digit = cell_widget_state.digit();
+    cell_state.tag = digit != 0 ? CellState::Tag::Digit : CellState::Tag::Candidates;
+    cell_state.candidates._0 = digit != 0 ? digit : cell_widget_state.candidate_mask();
+    return cell_state;
+}
+
+inline auto to_grid_state(const GridWidgetState& state) -> GridState {
+    GridState grid_state{};
+    for (int cell = 0; cell < 81; cell++) {
+        grid_state.grid[cell] = to_cell_state(state[cell]);
+    }
+    return grid_state;
+}
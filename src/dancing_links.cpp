@@ -0,0 +1,171 @@
+// A sudoku as an exact cover problem: 324 constraints (each cell filled,
+// each digit once per row, column and block) and 729 candidates that satisfy 4 of them each.
+// The matrix lives in fixed size arrays, nothing is allocated.
+
+#include "dancing_links.h"
+#include "sudoku_tables.h"
+
+namespace {
+    constexpr int N_COLUMNS = 324;
+    constexpr int N_ROWS = 729;
+    // the root, one header per column, then 4 nodes per row
+    constexpr int ROOT = 0;
+    constexpr int N_NODES = 1 + N_COLUMNS + 4 * N_ROWS;
+
+    class Matrix {
+        using Links = std::array<int16_t, N_NODES>;
+
+        Links m_left, m_right, m_up, m_down;
+        // header of the node's column
+        Links m_column;
+        // candidate of the node, cell * 9 + digit - 1
+        Links m_candidate;
+        // remaining nodes per column, indexed by header
+        std::array<int16_t, 1 + N_COLUMNS> m_size{};
+
+        Digits m_digits{};
+
+        auto cover(int column) -> void {
+            m_right[m_left[column]] = m_right[column];
+            m_left[m_right[column]] = m_left[column];
+            for (int row = m_down[column]; row != column; row = m_down[row]) {
+                for (int node = m_right[row]; node != row; node = m_right[node]) {
+                    m_down[m_up[node]] = m_down[node];
+                    m_up[m_down[node]] = m_up[node];
+                    m_size[m_column[node]]--;
+                }
+            }
+        }
+
+        auto uncover(int column) -> void {
+            for (int row = m_up[column]; row != column; row = m_up[row]) {
+                for (int node = m_left[row]; node != row; node = m_left[node]) {
+                    m_size[m_column[node]]++;
+                    m_down[m_up[node]] = node;
+                    m_up[m_down[node]] = node;
+                }
+            }
+            m_right[m_left[column]] = column;
+            m_left[m_right[column]] = column;
+        }
+
+        // the column of `row` is already covered
+        auto select(int row) -> void {
+            auto candidate = m_candidate[row];
+            m_digits[candidate / 9] = static_cast<uint8_t>(candidate % 9 + 1);
+            for (int node = m_right[row]; node != row; node = m_right[node]) {
+                this->cover(m_column[node]);
+            }
+        }
+
+        auto deselect(int row) -> void {
+            for (int node = m_left[row]; node != row; node = m_left[node]) {
+                this->uncover(m_column[node]);
+            }
+        }
+
+    public:
+        Matrix() {
+            for (int header = 0; header <= N_COLUMNS; header++) {
+                m_left[header] = static_cast<int16_t>(header == 0 ? N_COLUMNS : header - 1);
+                m_right[header] = static_cast<int16_t>(header == N_COLUMNS ? 0 : header + 1);
+                m_up[header] = m_down[header] = m_column[header] = static_cast<int16_t>(header);
+            }
+
+            auto node = 1 + N_COLUMNS;
+            for (int candidate = 0; candidate < N_ROWS; candidate++) {
+                auto cell = candidate / 9;
+                auto digit = candidate % 9;
+                auto [row, col, block] = HOUSES_OF_CELL[cell];
+                // houses are numbered consecutively, so that covers rows, columns and blocks
+                int headers[4] = { 1 + cell, 1 + 81 + row * 9 + digit, 1 + 81 + col * 9 + digit, 1 + 81 + block * 9 + digit };
+
+                for (int i = 0; i < 4; i++) {
+                    auto current = node + i;
+                    auto header = headers[i];
+                    m_left[current] = static_cast<int16_t>(node + (i + 3) % 4);
+                    m_right[current] = static_cast<int16_t>(node + (i + 1) % 4);
+                    m_column[current] = static_cast<int16_t>(header);
+                    m_candidate[current] = static_cast<int16_t>(candidate);
+
+                    m_up[current] = m_up[header];
+                    m_down[current] = static_cast<int16_t>(header);
+                    m_down[m_up[header]] = static_cast<int16_t>(current);
+                    m_up[header] = static_cast<int16_t>(current);
+                    m_size[header]++;
+                }
+                node += 4;
+            }
+        }
+
+        // Digits must not conflict, the columns they cover have to be distinct.
+        auto place(int cell, uint8_t digit) -> void {
+            auto row = 1 + N_COLUMNS + 4 * (cell * 9 + digit - 1);
+            this->cover(m_column[row]);
+            this->select(row);
+        }
+
+        auto search(uint8_t limit, SolutionCount& count) -> void {
+            if (m_right[ROOT] == ROOT) {
+                if (count.n_solutions == 0) {
+                    count.solution = m_digits;
+                }
+                count.n_solutions++;
+                return;
+            }
+
+            // fewest remaining candidates first
+            auto column = m_right[ROOT];
+            for (auto header = m_right[column]; header != ROOT; header = m_right[header]) {
+                if (m_size[header] < m_size[column]) {
+                    column = header;
+                }
+            }
+            if (m_size[column] == 0) {
+                return;
+            }
+
+            this->cover(column);
+            for (int row = m_down[column]; row != column && count.n_solutions < limit; row = m_down[row]) {
+                this->select(row);
+                this->search(limit, count);
+                this->deselect(row);
+            }
+            this->uncover(column);
+        }
+    };
+}
+
+auto dancing_links_count_solutions(const Digits& digits, uint8_t limit) -> SolutionCount {
+    SolutionCount count;
+
+    // conflicting digits would cover a column twice
+    std::array<uint16_t, 27> house_digits{};
+    for (int cell = 0; cell < 81; cell++) {
+        auto digit = digits[cell];
+        if (digit == 0) {
+            continue;
+        }
+        if (digit > 9) {
+            return count;
+        }
+        uint16_t bit = 1u << (digit - 1);
+        for (auto house : HOUSES_OF_CELL[cell]) {
+            if (house_digits[house] & bit) {
+                return count;
+            }
+            house_digits[house] |= bit;
+        }
+    }
+
+    Matrix matrix;
+    for (int cell = 0; cell < 81; cell++) {
+        if (digits[cell] != 0) {
+            matrix.place(cell, digits[cell]);
+        }
+    }
+    if (limit > 0) {
+        matrix.search(limit, count);
+    }
+    return count;
+}
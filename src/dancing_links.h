@@ -0,0 +1,8 @@
+#pragma once
+// Knuth's Algorithm X with dancing links, the alternative backend of brute_force.h.
+// Only built with -DSUDOKU_DLX=ON.
+
+#include "brute_force.h"
+
+// Same contract as `count_solutions`.
+auto dancing_links_count_solutions(const Digits& digits, uint8_t limit) -> SolutionCount;
@@ -0,0 +1,55 @@
+#include "ffi_handles.h"
+#include <atomic>
+#include <utility>
+
+namespace {
+    std::atomic<uint64_t> n_solvers = 0;
+    std::atomic<uint64_t> n_solve_results = 0;
+}
+
+auto ffi_handle_counts() -> FfiHandleCounts {
+    return FfiHandleCounts{
+        .solvers = n_solvers.load(std::memory_order_relaxed),
+        .solve_results = n_solve_results.load(std::memory_order_relaxed),
+    };
+}
+
+SolveResultsHandle::SolveResultsHandle(SolveResults results) : m_results(results) {
+    n_solve_results.fetch_add(1, std::memory_order_relaxed);
+}
+
+SolveResultsHandle::SolveResultsHandle(SolveResultsHandle&& other) noexcept
+    : m_results(std::exchange(other.m_results, SolveResults{})) {}
+
+auto SolveResultsHandle::operator=(SolveResultsHandle&& other) noexcept -> SolveResultsHandle& {
+    m_results = std::exchange(other.m_results, SolveResults{});
+    return *this;
+}
+
+auto SolveResultsHandle::is_solved() const -> bool {
+    return m_results.is_solved;
+}
+
+auto SolveResultsHandle::size() const -> size_t {
+    return deductions_len(m_results.deductions);
+}
+
+auto SolveResultsHandle::operator[](size_t index) const -> Deduction {
+    return deductions_get(m_results.deductions, index);
+}
+
+SolverHandle::SolverHandle(const GridState& grid_state) : m_solver(strategy_solver_from_grid_state(grid_state)) {
+    n_solvers.fetch_add(1, std::memory_order_relaxed);
+}
+
+SolverHandle::SolverHandle(SolverHandle&& other) noexcept : m_solver(std::exchange(other.m_solver, StrategySolver{})) {}
+
+auto SolverHandle::operator=(SolverHandle&& other) noexcept -> SolverHandle& {
+    m_solver = std::exchange(other.m_solver, StrategySolver{});
+    return *this;
+}
+
+auto SolverHandle::solve(std::span<const Strategy> strategies) && -> SolveResultsHandle {
+    auto solver = std::exchange(m_solver, StrategySolver{});
+    return SolveResultsHandle(strategy_solver_solve(solver, strategies.data(), strategies.size()));
+}
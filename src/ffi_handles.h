@@ -0,0 +1,53 @@
+#pragma once
+// Wrappers for the handles of the strategy solver bindings, and counts of how many were made.
+// The bindings export no functions to release solvers, deductions or conflicts, so these wrappers
+// free nothing and whatever a handle holds stays allocated for the rest of the process.
+// They exist so that every handle is made in one place and counted, the profiler overlay shows the counts.
+// Conflicts come with the deductions they're part of and are counted along with them.
+// Moved-from handles can only be assigned to.
+
+#include <cstdint>
+#include <span>
+#include "sudoku_ffi/sudoku.h"
+
+struct FfiHandleCounts {
+    uint64_t solvers;
+    uint64_t solve_results;
+};
+
+// handles made since the start of the process, by any thread
+auto ffi_handle_counts() -> FfiHandleCounts;
+
+// The deductions of one solver run. Move-only, so each run is read through one handle.
+class SolveResultsHandle {
+    SolveResults m_results;
+
+    friend class SolverHandle;
+    explicit SolveResultsHandle(SolveResults results);
+
+public:
+    SolveResultsHandle(const SolveResultsHandle&) = delete;
+    auto operator=(const SolveResultsHandle&) -> SolveResultsHandle& = delete;
+    SolveResultsHandle(SolveResultsHandle&& other) noexcept;
+    auto operator=(SolveResultsHandle&& other) noexcept -> SolveResultsHandle&;
+
+    auto is_solved() const -> bool;
+    auto size() const -> size_t;
+    auto operator[](size_t index) const -> Deduction;
+};
+
+// A solver for one grid. The bindings don't say whether solving changes a solver,
+// so it solves once and is used up by that. Move-only, so it can't be solved twice through a copy.
+class SolverHandle {
+    StrategySolver m_solver;
+
+public:
+    explicit SolverHandle(const GridState& grid_state);
+
+    SolverHandle(const SolverHandle&) = delete;
+    auto operator=(const SolverHandle&) -> SolverHandle& = delete;
+    SolverHandle(SolverHandle&& other) noexcept;
+    auto operator=(SolverHandle&& other) noexcept -> SolverHandle&;
+
+    auto solve(std::span<const Strategy> strategies) && -> SolveResultsHandle;
+};
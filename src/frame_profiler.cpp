@@ -0,0 +1,150 @@
+#include "frame_profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    std::atomic<uint32_t> NEXT_THREAD_ID = 0;
+
+    auto thread_id() -> uint32_t {
+        thread_local uint32_t id = NEXT_THREAD_ID++;
+        return id;
+    }
+
+    auto category(ProfileEvent event) -> const char* {
+        switch (event) {
+            case ProfileEvent::Frame:
+            case ProfileEvent::CellPaint:
+            case ProfileEvent::Digits:
+                return "paint";
+            case ProfileEvent::Edit:
+            case ProfileEvent::KeyToPaint:
+                return "input";
+            case ProfileEvent::Hint:
+                return "solver";
+        }
+        return "";
+    }
+
+    // nearest rank
+    auto percentile(const std::vector<uint64_t>& sorted, int percent) -> uint64_t {
+        auto rank = (sorted.size() * percent + 99) / 100;
+        return sorted[std::max<size_t>(rank, 1) - 1];
+    }
+}
+
+auto profile_event_name(ProfileEvent event) -> const char* {
+    switch (event) {
+        case ProfileEvent::Frame:
+            return "frame";
+        case ProfileEvent::CellPaint:
+            return "cell paint";
+        case ProfileEvent::Digits:
+            return "digits";
+        case ProfileEvent::Edit:
+            return "edit";
+        case ProfileEvent::KeyToPaint:
+            return "key to paint";
+        case ProfileEvent::Hint:
+            return "hint";
+    }
+    return "";
+}
+
+auto FrameProfiler::now() -> uint64_t {
+    auto since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count();
+}
+
+auto FrameProfiler::record(ProfileEvent event, uint64_t start_ns, uint64_t end_ns) -> void {
+    auto ticket = m_head.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = (*m_slots)[ticket % CAPACITY];
+
+    slot.sequence.store(2 * ticket + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.duration_ns.store(end_ns - start_ns, std::memory_order_relaxed);
+    slot.info.store(static_cast<uint64_t>(thread_id()) << 8 | static_cast<uint8_t>(event), std::memory_order_relaxed);
+    slot.sequence.store(2 * (ticket + 1), std::memory_order_release);
+}
+
+auto FrameProfiler::snapshot() const -> std::vector<ProfileSample> {
+    auto head = m_head.load(std::memory_order_acquire);
+    auto first = head > CAPACITY ? head - CAPACITY : 0;
+
+    std::vector<ProfileSample> samples;
+    samples.reserve(head - first);
+    for (auto ticket = first; ticket < head; ticket++) {
+        const auto& slot = (*m_slots)[ticket % CAPACITY];
+
+        auto sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * (ticket + 1)) {
+            continue; // still being written or already overwritten
+        }
+        auto start_ns = slot.start_ns.load(std::memory_order_relaxed);
+        auto duration_ns = slot.duration_ns.load(std::memory_order_relaxed);
+        auto info = slot.info.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+
+        samples.push_back(ProfileSample{
+            .event = static_cast<ProfileEvent>(info & 0xFF),
+            .thread = static_cast<uint32_t>(info >> 8),
+            .start_ns = start_ns,
+            .duration_ns = duration_ns,
+        });
+    }
+    return samples;
+}
+
+auto FrameProfiler::summarize(const std::vector<ProfileSample>& samples, ProfileEvent event)
+    -> std::optional<ProfileSummary> {
+    std::vector<uint64_t> durations;
+    for (const auto& sample : samples) {
+        if (sample.event == event) {
+            durations.push_back(sample.duration_ns);
+        }
+    }
+    if (durations.empty()) {
+        return {};
+    }
+
+    std::sort(durations.begin(), durations.end());
+    return ProfileSummary{
+        .n_samples = durations.size(),
+        .p50_ns = percentile(durations, 50),
+        .p99_ns = percentile(durations, 99),
+        .max_ns = durations.back(),
+    };
+}
+
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+// complete events ("ph": "X") with microsecond timestamps relative to the oldest sample
+auto FrameProfiler::write_chrome_trace(std::ostream& out) const -> void {
+    auto samples = this->snapshot();
+    uint64_t origin_ns = UINT64_MAX;
+    for (const auto& sample : samples) {
+        origin_ns = std::min(origin_ns, sample.start_ns);
+    }
+
+    out << "{\"traceEvents\":[";
+    auto first = true;
+    for (const auto& sample : samples) {
+        char line[256];
+        std::snprintf(
+            line,
+            sizeof(line),
+            "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            first ? "" : ",",
+            profile_event_name(sample.event),
+            category(sample.event),
+            sample.thread,
+            (sample.start_ns - origin_ns) / 1000.0,
+            sample.duration_ns / 1000.0);
+        out << line;
+        first = false;
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
@@ -0,0 +1,93 @@
+#pragma once
+// Timings of painting, input handling and the solver, for finding out where latency comes from.
+// Samples go into a fixed size ring buffer that any thread can write to without locking.
+// Once it's full, the oldest samples are overwritten.
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+enum class ProfileEvent : uint8_t {
+    Frame,      // all cell paints of one repaint
+    CellPaint,  // painting one cell
+    Digits,     // drawing the digit or pencil marks of a cell paint
+    Edit,       // grid update for a key press, including the savepoint
+    KeyToPaint, // key press until the end of the repaint it caused
+    Hint,       // strategy solver run on a worker thread
+};
+
+constexpr size_t N_PROFILE_EVENTS = 6;
+
+auto profile_event_name(ProfileEvent event) -> const char*;
+
+struct ProfileSample {
+    ProfileEvent event;
+    // small sequential id, not the OS thread id
+    uint32_t thread;
+    // steady clock, nanoseconds
+    uint64_t start_ns;
+    uint64_t duration_ns;
+};
+
+struct ProfileSummary {
+    size_t n_samples;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+};
+
+class FrameProfiler {
+    static constexpr size_t CAPACITY = 1 << 15;
+
+    // Per slot seqlock. The sequence is odd while the slot is written
+    // and 2 * (ticket + 1) once sample number `ticket` is complete.
+    // The fields are atomics so that torn reads are merely discarded, not undefined.
+    struct Slot {
+        std::atomic<uint64_t> sequence = 0;
+        std::atomic<uint64_t> start_ns = 0;
+        std::atomic<uint64_t> duration_ns = 0;
+        // event in the low byte, thread above
+        std::atomic<uint64_t> info = 0;
+    };
+
+    std::unique_ptr<std::array<Slot, CAPACITY>> m_slots = std::make_unique<std::array<Slot, CAPACITY>>();
+    // number of samples ever recorded
+    std::atomic<uint64_t> m_head = 0;
+
+public:
+    static auto now() -> uint64_t;
+
+    auto record(ProfileEvent event, uint64_t start_ns, uint64_t end_ns) -> void;
+
+    // The samples currently in the buffer, oldest first.
+    // Samples that are overwritten while they are read are skipped.
+    auto snapshot() const -> std::vector<ProfileSample>;
+
+    // Nothing if there are no samples of that kind.
+    static auto summarize(const std::vector<ProfileSample>& samples, ProfileEvent event)
+        -> std::optional<ProfileSummary>;
+
+    // Chrome trace event format, for chrome://tracing or Perfetto.
+    auto write_chrome_trace(std::ostream& out) const -> void;
+};
+
+// Records the time from construction to destruction.
+class ScopedProfile {
+    FrameProfiler& m_profiler;
+    ProfileEvent m_event;
+    uint64_t m_start_ns;
+
+public:
+    ScopedProfile(FrameProfiler& profiler, ProfileEvent event)
+        : m_profiler(profiler), m_event(event), m_start_ns(FrameProfiler::now()) {}
+    ~ScopedProfile() {
+        m_profiler.record(m_event, m_start_ns, FrameProfiler::now());
+    }
+
+    ScopedProfile(const ScopedProfile&) = delete;
+    auto operator=(const ScopedProfile&) -> ScopedProfile& = delete;
+};
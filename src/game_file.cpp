@@ -0,0 +1,366 @@
+#include "game_file.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace {
+    constexpr char GAME_MAGIC[4] = { 'S', 'D', 'K', 'G' };
+    constexpr uint16_t GAME_VERSION = 2;
+    constexpr uint16_t LINEAR_GAME_VERSION = 1;
+
+    constexpr char ARCHIVE_MAGIC[8] = { 'S', 'D', 'K', 'A', 'R', 'C', 'H', '1' };
+    constexpr uint32_t ARCHIVE_VERSION = 1;
+    constexpr size_t ARCHIVE_HEADER_SIZE = 24;
+    constexpr size_t INDEX_ENTRY_SIZE = 64;
+    constexpr size_t INDEX_NAME_OFFSET = 16;
+    static_assert(INDEX_NAME_OFFSET + GameArchive::MAX_NAME_LENGTH == INDEX_ENTRY_SIZE);
+
+    // unsigned integers, little endian
+    template <typename T>
+    auto put(std::string& out, T value) -> void {
+        for (size_t i = 0; i < sizeof(T); i++) {
+            out.push_back(static_cast<char>(value >> (8 * i) & 0xFF));
+        }
+    }
+
+    template <typename T>
+    auto get(const char* data) -> T {
+        T value = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            value |= static_cast<T>(static_cast<T>(static_cast<uint8_t>(data[i])) << (8 * i));
+        }
+        return value;
+    }
+
+    // Reads front to back. Reading past the end yields zeros and marks the reader as failed.
+    class Reader {
+        std::string_view m_bytes;
+        bool m_failed = false;
+
+    public:
+        explicit Reader(std::string_view bytes) : m_bytes(bytes) {}
+
+        template <typename T>
+        auto read() -> T {
+            if (m_bytes.size() < sizeof(T)) {
+                m_failed = true;
+                m_bytes = {};
+                return 0;
+            }
+            auto value = get<T>(m_bytes.data());
+            m_bytes.remove_prefix(sizeof(T));
+            return value;
+        }
+
+        auto remaining() const -> size_t {
+            return m_bytes.size();
+        }
+
+        auto failed() const -> bool {
+            return m_failed;
+        }
+    };
+
+    // stdio instead of streams for the errno on failure
+    class OutputFile {
+        std::string m_path;
+        std::FILE* m_file;
+
+        [[noreturn]] auto fail() const -> void {
+            throw std::system_error(errno, std::generic_category(), m_path);
+        }
+
+    public:
+        explicit OutputFile(std::string path) : m_path(std::move(path)), m_file(std::fopen(m_path.c_str(), "wb")) {
+            if (m_file == nullptr) {
+                this->fail();
+            }
+        }
+
+        ~OutputFile() {
+            if (m_file != nullptr) {
+                std::fclose(m_file);
+            }
+        }
+
+        OutputFile(const OutputFile&) = delete;
+        auto operator=(const OutputFile&) -> OutputFile& = delete;
+
+        auto write(std::string_view bytes) -> void {
+            if (std::fwrite(bytes.data(), 1, bytes.size(), m_file) != bytes.size()) {
+                this->fail();
+            }
+        }
+
+        auto seek(long offset) -> void {
+            if (std::fseek(m_file, offset, SEEK_SET) != 0) {
+                this->fail();
+            }
+        }
+
+        // flushes, so that write errors surface here and not in the destructor
+        auto close() -> void {
+            auto* file = std::exchange(m_file, nullptr);
+            if (std::fclose(file) != 0) {
+                this->fail();
+            }
+        }
+    };
+
+    // Deletes the file at `path` on destruction unless it was kept, so a failed write leaves nothing behind.
+    // Has to outlive the OutputFile writing to it.
+    class TemporaryFile {
+        std::string m_path;
+        bool m_is_kept = false;
+
+    public:
+        explicit TemporaryFile(std::string path) : m_path(std::move(path)) {}
+
+        ~TemporaryFile() {
+            if (!m_is_kept) {
+                std::error_code error;
+                std::filesystem::remove(m_path, error);
+            }
+        }
+
+        TemporaryFile(const TemporaryFile&) = delete;
+        auto operator=(const TemporaryFile&) -> TemporaryFile& = delete;
+
+        auto path() const -> const std::string& {
+            return m_path;
+        }
+
+        // moves the file to `path`, it is no longer removed
+        auto rename_to(const std::string& path) -> void {
+            std::filesystem::rename(m_path, path);
+            m_is_kept = true;
+        }
+    };
+}
+
+auto encode_game(const SavedGame& game) -> std::string {
+    std::string out;
+    out.reserve(8 + 81 * 2 + 12 + game.step_ends.size() * 8 + game.deltas.size() * 5);
+
+    out.append(GAME_MAGIC, sizeof(GAME_MAGIC));
+    put<uint16_t>(out, GAME_VERSION);
+    put<uint8_t>(out, game.highlighted_digit);
+    put<uint8_t>(out, 0);
+
+    for (auto cell_state : game.initial) {
+        put<uint16_t>(out, cell_state.bits());
+    }
+
+    put<uint32_t>(out, game.position);
+    put<uint32_t>(out, game.step_ends.size());
+    put<uint32_t>(out, game.deltas.size());
+    for (auto end : game.step_ends) {
+        put<uint32_t>(out, end);
+    }
+    for (uint32_t step = 0; step < game.step_ends.size(); step++) {
+        put<uint32_t>(out, game.parents.empty() ? step : game.parents[step]);
+    }
+    for (const auto& delta : game.deltas) {
+        put<uint8_t>(out, delta.cell);
+        put<uint16_t>(out, delta.old_state.bits());
+        put<uint16_t>(out, delta.new_state.bits());
+    }
+    return out;
+}
+
+auto decode_game(std::string_view bytes) -> std::optional<SavedGame> {
+    if (bytes.size() < sizeof(GAME_MAGIC) || std::memcmp(bytes.data(), GAME_MAGIC, sizeof(GAME_MAGIC)) != 0) {
+        return {};
+    }
+    Reader reader(bytes.substr(sizeof(GAME_MAGIC)));
+    auto version = reader.read<uint16_t>();
+    if (version != GAME_VERSION && version != LINEAR_GAME_VERSION) {
+        return {};
+    }
+    auto has_parents = version == GAME_VERSION;
+
+    // a digit out of range would index past the candidate engine's tables
+    auto are_states_valid = true;
+    auto read_state = [&]() {
+        auto bits = reader.read<uint16_t>();
+        are_states_valid &= CellWidgetState::is_valid_bits(bits);
+        return CellWidgetState::from_bits(bits);
+    };
+
+    SavedGame game;
+    game.highlighted_digit = reader.read<uint8_t>();
+    reader.read<uint8_t>();
+    for (auto& cell_state : game.initial) {
+        cell_state = read_state();
+    }
+
+    game.position = reader.read<uint32_t>();
+    auto n_steps = reader.read<uint32_t>();
+    auto n_deltas = reader.read<uint32_t>();
+    // don't trust the counts with an allocation before checking them against the size
+    auto step_size = has_parents ? 8 : 4;
+    if (reader.failed() || reader.remaining() != uint64_t(n_steps) * step_size + uint64_t(n_deltas) * 5) {
+        return {};
+    }
+
+    game.step_ends.reserve(n_steps);
+    for (uint32_t step = 0; step < n_steps; step++) {
+        game.step_ends.push_back(reader.read<uint32_t>());
+    }
+    if (has_parents) {
+        game.parents.reserve(n_steps);
+        for (uint32_t step = 0; step < n_steps; step++) {
+            game.parents.push_back(reader.read<uint32_t>());
+        }
+    }
+    game.deltas.reserve(n_deltas);
+    for (uint32_t i = 0; i < n_deltas; i++) {
+        auto cell = reader.read<uint8_t>();
+        auto old_state = read_state();
+        auto new_state = read_state();
+        game.deltas.push_back(CellDelta{ .cell = cell, .old_state = old_state, .new_state = new_state });
+    }
+
+    if (game.highlighted_digit > 9 || !are_states_valid) {
+        return {};
+    }
+    return game;
+}
+
+auto write_game_file(const std::string& path, const SavedGame& game) -> void {
+    OutputFile file(path);
+    file.write(encode_game(game));
+    file.close();
+}
+
+auto read_game_file(const std::string& path) -> SavedGame {
+    MappedFile file(path);
+    auto game = decode_game(file.view());
+    if (!game.has_value()) {
+        throw std::runtime_error(path + " is not a saved game");
+    }
+    return std::move(*game);
+}
+
+GameArchive::GameArchive(const std::string& path) : m_file(path, FileAccess::Random) {
+    auto bytes = m_file.view();
+    auto is_archive = bytes.size() >= ARCHIVE_HEADER_SIZE
+        && std::memcmp(bytes.data(), ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) == 0
+        && get<uint32_t>(bytes.data() + 8) == ARCHIVE_VERSION;
+
+    if (is_archive) {
+        m_n_games = get<uint32_t>(bytes.data() + 12);
+        auto index_offset = get<uint64_t>(bytes.data() + 16);
+        is_archive = index_offset <= bytes.size() && (bytes.size() - index_offset) / INDEX_ENTRY_SIZE >= m_n_games;
+        m_index = bytes.data() + index_offset;
+    }
+    if (!is_archive) {
+        throw std::runtime_error(path + " is not a game archive");
+    }
+}
+
+auto GameArchive::entry(size_t game) const -> const char* {
+    return m_index + game * INDEX_ENTRY_SIZE;
+}
+
+// nothing if the entry points outside of the file
+auto GameArchive::record(size_t game) const -> std::optional<std::string_view> {
+    auto* entry = this->entry(game);
+    auto offset = get<uint64_t>(entry);
+    auto size = get<uint32_t>(entry + 8);
+    if (offset > m_file.size() || size > m_file.size() - offset) {
+        return {};
+    }
+    return m_file.view().substr(offset, size);
+}
+
+auto GameArchive::size() const -> size_t {
+    return m_n_games;
+}
+
+auto GameArchive::name(size_t game) const -> std::string_view {
+    auto* name = this->entry(game) + INDEX_NAME_OFFSET;
+    return std::string_view(name, strnlen(name, MAX_NAME_LENGTH));
+}
+
+auto GameArchive::find(std::string_view name) const -> std::optional<size_t> {
+    for (size_t game = 0; game < m_n_games; game++) {
+        if (this->name(game) == name) {
+            return game;
+        }
+    }
+    return {};
+}
+
+auto GameArchive::load(size_t game) const -> std::optional<SavedGame> {
+    auto record = this->record(game);
+    if (!record.has_value()) {
+        return {};
+    }
+    return decode_game(*record);
+}
+
+auto GameArchive::store(const std::string& path, std::string_view name, const SavedGame& game) -> void {
+    name = name.substr(0, MAX_NAME_LENGTH);
+
+    std::optional<GameArchive> old;
+    if (std::filesystem::exists(path)) {
+        old.emplace(path);
+    }
+
+    struct IndexEntry {
+        uint64_t offset;
+        uint32_t size;
+        std::string_view name;
+    };
+    std::vector<IndexEntry> index;
+
+    TemporaryFile temporary(path + ".tmp");
+    OutputFile file(temporary.path());
+    file.write(std::string(ARCHIVE_HEADER_SIZE, '\0'));
+    uint64_t offset = ARCHIVE_HEADER_SIZE;
+
+    auto add_record = [&](std::string_view record, std::string_view record_name) {
+        file.write(record);
+        index.push_back(IndexEntry{ .offset = offset, .size = static_cast<uint32_t>(record.size()), .name = record_name });
+        offset += record.size();
+    };
+
+    if (old.has_value()) {
+        for (size_t i = 0; i < old->size(); i++) {
+            if (old->name(i) == name) {
+                continue;
+            }
+            auto record = old->record(i);
+            if (!record.has_value()) {
+                throw std::runtime_error(path + " has a damaged index entry");
+            }
+            add_record(*record, old->name(i));
+        }
+    }
+    add_record(encode_game(game), name);
+
+    std::string index_bytes;
+    for (const auto& entry : index) {
+        put<uint64_t>(index_bytes, entry.offset);
+        put<uint32_t>(index_bytes, entry.size);
+        put<uint32_t>(index_bytes, 0);
+        index_bytes.append(entry.name);
+        index_bytes.append(MAX_NAME_LENGTH - entry.name.size(), '\0');
+    }
+    file.write(index_bytes);
+
+    std::string header(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    put<uint32_t>(header, ARCHIVE_VERSION);
+    put<uint32_t>(header, index.size());
+    put<uint64_t>(header, offset);
+    file.seek(0);
+    file.write(header);
+    file.close();
+
+    temporary.rename_to(path);
+}
@@ -0,0 +1,88 @@
+#pragma once
+// Binary save format for games in progress, on its own or many to an archive.
+//
+// A game record is, little endian throughout:
+//
+//   "SDKG" u16 version  u8 highlighted digit  u8 reserved
+//   81 x u16 initial cell states (CellWidgetState bits, so clues are marked)
+//   u32 current node  u32 number of steps  u32 number of deltas
+//   u32 x steps    end of each undo step in the deltas
+//   u32 x steps    node each step was made from, 0 for the initial state and n for step n
+//   5 bytes x deltas: u8 cell, u16 old state, u16 new state
+//
+// Version 1 records have no parents, every step follows the one before. They're still read.
+//
+// An archive is a header, the records back to back and an index with one fixed size entry per game:
+//
+//   "SDKARCH1" u32 version  u32 number of games  u64 offset of the index
+//   records
+//   index entries: u64 offset  u32 size  u32 reserved  48 bytes name, zero padded
+//
+// The archive is memory-mapped. Opening it reads the header, the index entries are read on access,
+// and a game's record is only paged in when that game is loaded.
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "cell_state.h"
+#include "mapped_file.h"
+#include "undo_journal.h"
+
+struct SavedGame {
+    // the state the undo history starts from
+    GridWidgetState initial{};
+    // the whole history, including undone steps
+    std::vector<CellDelta> deltas;
+    std::vector<uint32_t> step_ends;
+    // empty if the history has no branches
+    std::vector<uint32_t> parents;
+    // node of the undo tree the game is at, 0 for the initial state
+    uint32_t position = 0;
+
+    // 1-9, 0 for no highlight
+    uint8_t highlighted_digit = 0;
+};
+
+auto encode_game(const SavedGame& game) -> std::string;
+// Nothing if `bytes` is not a game record of a known version or holds cell states that can't exist.
+// The history is checked by UndoJournal::restore, not here.
+auto decode_game(std::string_view bytes) -> std::optional<SavedGame>;
+
+// Single game files. Both throw std::system_error on I/O errors,
+// reading throws std::runtime_error if the file isn't a saved game.
+auto write_game_file(const std::string& path, const SavedGame& game) -> void;
+auto read_game_file(const std::string& path) -> SavedGame;
+
+class GameArchive {
+    MappedFile m_file;
+    uint32_t m_n_games = 0;
+    const char* m_index = nullptr;
+
+    auto entry(size_t game) const -> const char*;
+    auto record(size_t game) const -> std::optional<std::string_view>;
+
+public:
+    static constexpr size_t MAX_NAME_LENGTH = 48;
+
+    // Throws std::system_error if the file can't be mapped
+    // and std::runtime_error if it isn't an archive.
+    explicit GameArchive(const std::string& path);
+
+    auto size() const -> size_t;
+    auto name(size_t game) const -> std::string_view;
+    // linear search through the index
+    auto find(std::string_view name) const -> std::optional<size_t>;
+    // Nothing if the record is damaged.
+    auto load(size_t game) const -> std::optional<SavedGame>;
+
+    // Add `game` to the archive at `path` under `name`, which is cut off at MAX_NAME_LENGTH.
+    // A game of the same name is replaced, a missing archive is created.
+    // The other records are copied over byte for byte without decoding them.
+    // The new archive is written next to the old one and renamed over it,
+    // so readers that still map the old file are not disturbed.
+    // Throws like the constructor, std::runtime_error if an old record is out of the file's bounds
+    // and std::system_error if writing fails. The old archive is left as it was and the new one removed.
+    static auto store(const std::string& path, std::string_view name, const SavedGame& game) -> void;
+};
@@ -0,0 +1,78 @@
+#include "grading.h"
+#include "candidate_engine.h"
+#include "cell_state.h"
+#include "ffi_handles.h"
+#include "hint.h"
+
+namespace {
+    // the clues with the candidates they leave, converted once for all solves of a sudoku
+    auto clue_grid_state(const Sudoku& sudoku) -> GridState {
+        GridWidgetState state;
+        for (int cell = 0; cell < 81; cell++) {
+            auto digit = sudoku._0[cell];
+            state[cell] = digit != 0 ? CellWidgetState::clue(digit) : CellWidgetState::from_candidates(0x1FF);
+        }
+        CandidateEngine engine;
+        engine.reset(state);
+        engine.restrict_candidates(state);
+        return to_grid_state(state);
+    }
+
+    auto solve_with(const GridState& clues, const Sudoku& sudoku, std::span<const Strategy> strategies)
+        -> SolveOutcome {
+        auto deductions = SolverHandle(clues).solve(strategies);
+
+        SolveOutcome outcome;
+        outcome.n_deductions = deductions.size();
+        for (int cell = 0; cell < 81; cell++) {
+            outcome.digits[cell] = sudoku._0[cell];
+        }
+
+        // only placements fill cells, eliminations don't need to be replayed
+        for (uint32_t i = 0; i < outcome.n_deductions; i++) {
+            auto effects = deduction_effects(deductions[i]);
+            if (effects.placement.has_value()) {
+                outcome.digits[effects.placement->cell] = effects.placement->num;
+            }
+        }
+
+        outcome.is_solved = true;
+        for (auto digit : outcome.digits) {
+            outcome.is_solved &= digit != 0;
+        }
+        return outcome;
+    }
+
+    // Solvability only grows with more strategies, so the grade can be found
+    // by bisecting over prefixes of STRATEGIES.
+    auto grade_with(const GridState& clues, const Sudoku& sudoku) -> uint8_t {
+        // invariant: the first `high` strategies suffice, the first `low` don't
+        size_t low = 0;
+        size_t high = N_GRADES;
+        while (high - low > 1) {
+            auto mid = (low + high) / 2;
+            if (solve_with(clues, sudoku, std::span(STRATEGIES.data(), mid)).is_solved) {
+                high = mid;
+            } else {
+                low = mid;
+            }
+        }
+        return static_cast<uint8_t>(high - 1);
+    }
+}
+
+auto solve_with_strategies(const Sudoku& sudoku, std::span<const Strategy> strategies) -> SolveOutcome {
+    return solve_with(clue_grid_state(sudoku), sudoku, strategies);
+}
+
+auto grade_sudoku(const Sudoku& sudoku) -> std::optional<uint8_t> {
+    auto clues = clue_grid_state(sudoku);
+    if (!solve_with(clues, sudoku, STRATEGIES).is_solved) {
+        return {};
+    }
+    return grade_with(clues, sudoku);
+}
+
+auto grade_solvable_sudoku(const Sudoku& sudoku) -> uint8_t {
+    return grade_with(clue_grid_state(sudoku), sudoku);
+}
@@ -0,0 +1,28 @@
+#pragma once
+// Solve sudokus with a given set of strategies and rate them
+// by the hardest strategy they require.
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include "sudoku_ffi/sudoku.h"
+#include "strategies.h"
+
+struct SolveOutcome {
+    bool is_solved = false;
+    uint32_t n_deductions = 0;
+    // the filled in grid, 0 where the strategies got stuck
+    std::array<uint8_t, 81> digits{};
+};
+
+// Run the strategy solver from the clues of `sudoku`
+// and replay its deductions to see how far they get.
+auto solve_with_strategies(const Sudoku& sudoku, std::span<const Strategy> strategies) -> SolveOutcome;
+
+// Index into STRATEGIES of the hardest strategy needed to solve `sudoku`,
+// nothing if all of them together don't suffice.
+auto grade_sudoku(const Sudoku& sudoku) -> std::optional<uint8_t>;
+
+// Same as `grade_sudoku`, for a sudoku already known to be solvable with all of STRATEGIES.
+auto grade_solvable_sudoku(const Sudoku& sudoku) -> uint8_t;
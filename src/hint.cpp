@@ -0,0 +1,291 @@
+#include "hint.h"
+#include "ffi_handles.h"
+#include "native_solver.h"
+#include "sudoku_helper.h"
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+
+Hint::Hint() {
+    cell_highlights.fill(HintHighlight::None);
+}
+
+auto Hint::set_house_highlight(int house, HintHighlight highlight) -> void {
+    assert(house < 27);
+    foreach_cell_in_house(house, [&](int cell) { this->set_cell_highlight(cell, highlight); });
+}
+
+auto Hint::set_cell_highlight(int cell, HintHighlight highlight) -> void {
+    assert(cell < 81);
+    cell_highlights[cell] = highlight;
+}
+
+// digit is 0-based
+// a later highlight of the same candidate replaces an earlier one
+auto Hint::set_digit_highlight(int cell, int digit, bool is_conflict) -> void {
+    uint16_t bit = 1u << digit;
+    if (is_conflict) {
+        digit_highlights[cell] &= ~bit;
+        conflict_highlights[cell] |= bit;
+    } else {
+        digit_highlights[cell] |= bit;
+        conflict_highlights[cell] &= ~bit;
+    }
+}
+
+namespace {
+    auto collect_conflicts(Conflicts conflicts) -> std::vector<Candidate> {
+        std::vector<Candidate> result;
+        auto len = conflicts_len(conflicts);
+        result.reserve(len);
+        for (uint32_t i = 0; i < len; i++) {
+            result.push_back(conflicts_get(conflicts, i));
+        }
+        return result;
+    }
+}
+
+auto deduction_effects(const Deduction& deduction) -> DeductionEffects {
+    switch (deduction.tag) {
+        case DeductionTag::NakedSingles:
+            return { .placement = deduction.data.naked_singles.candidate, .eliminations = {} };
+        case DeductionTag::HiddenSingles:
+            return { .placement = deduction.data.hidden_singles.candidate, .eliminations = {} };
+        case DeductionTag::LockedCandidates:
+            return { .placement = {}, .eliminations = collect_conflicts(deduction.data.locked_candidates.conflicts) };
+        case DeductionTag::Subsets:
+            return { .placement = {}, .eliminations = collect_conflicts(deduction.data.subsets.conflicts) };
+        case DeductionTag::BasicFish:
+            return { .placement = {}, .eliminations = collect_conflicts(deduction.data.basic_fish.conflicts) };
+        case DeductionTag::Wing:
+            return { .placement = {}, .eliminations = collect_conflicts(deduction.data.wing.conflicts) };
+        default:
+            return {};
+    }
+}
+
+namespace {
+    // mark the digit to enter and the candidates to remove
+    auto highlight_effects(Hint& hint) -> void {
+        if (hint.candidate.has_value()) {
+            auto candidate = *hint.candidate;
+            hint.set_digit_highlight(candidate.cell, candidate.num - 1, false);
+        }
+
+        for (auto conflict : hint.conflicts) {
+            hint.set_digit_highlight(conflict.cell, conflict.num - 1, true);
+        }
+    }
+}
+
+// find and mark cell
+// also give a lighter highlight to all cells in the same line or col
+// to guide the eyes
+auto naked_single_hint(Candidate candidate) -> Hint {
+    Hint hint;
+    hint.candidate = candidate;
+
+    auto cell = candidate.cell;
+    hint.set_house_highlight(row(cell), HintHighlight::Weak);
+    hint.set_house_highlight(col(cell) + 9, HintHighlight::Weak);
+    hint.set_cell_highlight(cell, HintHighlight::Strong);
+
+    highlight_effects(hint);
+    return hint;
+}
+
+auto hidden_single_hint(Candidate candidate, HouseType house_type) -> Hint {
+    Hint hint;
+    hint.candidate = candidate;
+
+    auto house = house_of_cell(candidate.cell, house_type);
+    hint.set_house_highlight(house, HintHighlight::Weak);
+    hint.set_cell_highlight(candidate.cell, HintHighlight::Strong);
+
+    highlight_effects(hint);
+    return hint;
+}
+
+auto locked_candidates_hint(uint8_t digit, uint8_t miniline, bool is_pointing, std::vector<Candidate> conflicts)
+    -> Hint {
+    Hint hint;
+    hint.conflicts = std::move(conflicts);
+
+    auto block = block_of_miniline(miniline);
+    auto line = line_of_miniline(miniline);
+
+    hint.set_house_highlight(block + 18, HintHighlight::Weak);
+    hint.set_house_highlight(line, HintHighlight::Weak);
+
+    auto set_digit_highlights = [&](int cell) { hint.set_digit_highlight(cell, digit - 1, false); };
+    if (is_pointing) {
+        foreach_cell_in_block(block, set_digit_highlights);
+    } else {
+        foreach_cell_in_house(line, set_digit_highlights);
+    }
+
+    highlight_effects(hint);
+    return hint;
+}
+
+auto hint_from_deduction(const Deduction& deduction) -> Hint {
+    switch (deduction.tag) {
+        case DeductionTag::NakedSingles:
+            return naked_single_hint(deduction.data.naked_singles.candidate);
+        case DeductionTag::HiddenSingles: {
+            auto data = deduction.data.hidden_singles;
+            return hidden_single_hint(data.candidate, data.house_type);
+        }
+        case DeductionTag::LockedCandidates: {
+            auto data = deduction.data.locked_candidates;
+            return locked_candidates_hint(data.digit, data.miniline, data.is_pointing, collect_conflicts(data.conflicts));
+        }
+        default:
+            break;
+    }
+
+    Hint hint;
+    auto effects = deduction_effects(deduction);
+    hint.candidate = effects.placement;
+    hint.conflicts = std::move(effects.eliminations);
+
+    switch (deduction.tag) {
+        case DeductionTag::Subsets: {
+            auto data = deduction.data.subsets;
+            hint.set_house_highlight(data.house, HintHighlight::Weak);
+            auto digits = std::bitset<9>(data.digits);
+            auto positions = std::bitset<9>(data.positions);
+            for (int pos = 0; pos < 9; pos++) {
+                if (!positions[pos]) {
+                    continue;
+                }
+                auto cell = cell_at_position(data.house, pos);
+                hint.set_cell_highlight(cell, HintHighlight::Strong);
+
+                for (int digit = 0; digit < 9; digit++) {
+                    if (!digits[digit]) {
+                        continue;
+                    }
+                    hint.set_digit_highlight(cell, digit, false);
+                }
+            }
+            break;
+        }
+        case DeductionTag::BasicFish: {
+            auto data = deduction.data.basic_fish;
+            auto lines = std::bitset<18>(data.lines);
+            auto positions = std::bitset<9>(data.positions);
+            auto digit = data.digit;
+
+            for (int line = 0; line < 18; line++) {
+                if (!lines[line]) {
+                    continue;
+                }
+                hint.set_house_highlight(line, HintHighlight::Weak);
+                for (int pos = 0; pos < 9; pos++) {
+                    if (!positions[pos]) {
+                        continue;
+                    }
+                    auto cell = cell_at_position(line, pos);
+                    hint.set_cell_highlight(cell, HintHighlight::Strong);
+                    hint.set_digit_highlight(cell, digit - 1, false);
+                }
+            }
+            break;
+        }
+        case DeductionTag::Wing: {
+            auto data = deduction.data.wing;
+            auto digits = std::bitset<9>(data.hinge_digits);
+            auto pincer_cells = CellSet(data.pincers[0], data.pincers[1]);
+
+            auto affected_cells = std::vector<int>{ data.hinge };
+            pincer_cells.foreach([&](int cell) { affected_cells.push_back(cell); });
+
+            for (auto pattern_cell : affected_cells) {
+                hint.set_cell_highlight(pattern_cell, HintHighlight::Strong);
+                for (int digit = 0; digit < 9; digit++) {
+                    if (!digits[digit]) {
+                        continue;
+                    }
+                    hint.set_digit_highlight(pattern_cell, digit, false);
+                }
+            }
+            break;
+        }
+        /*
+        case DeductionTag::Fish: {
+            auto data = deduction.data.fish;
+            break;
+        }
+        case DeductionTag::AvoidableRectangle: {
+            auto data = deduction.data.avoidable_rectangle;
+            break;
+        }
+        */
+        default:
+            break;
+    }
+
+    highlight_effects(hint);
+    return hint;
+}
+
+auto compute_hint(const GridState& grid_state, const std::vector<Strategy>& strategies) -> std::optional<Hint> {
+    auto native = native_hint(grid_state, strategies);
+    if (native.is_conclusive) {
+        return std::move(native.hint);
+    }
+
+    auto deductions = SolverHandle(grid_state).solve(strategies);
+    if (deductions.size() == 0) {
+        return {}; // nothing found
+    }
+    return hint_from_deduction(deductions[0]);
+}
+
+// FNV-1a over the packed grid and the strategy list
+auto HintKey::hash() const -> uint64_t {
+    uint64_t hash = 0xcbf29ce484222325;
+    auto add = [&](uint64_t value) {
+        hash ^= value;
+        hash *= 0x100000001b3;
+    };
+
+    for (auto cell_state : grid) {
+        add(cell_state.bits());
+    }
+    for (auto strategy : strategies) {
+        // cell states only use the low 16 bits, tagging above them keeps strategies apart from cells
+        add(static_cast<uint64_t>(strategy) | 1ull << 32);
+    }
+    return hash;
+}
+
+auto HintCache::find(const HintKey& key) -> const std::optional<Hint>* {
+    auto hash = key.hash();
+    auto entry = std::find_if(m_entries.begin(), m_entries.end(), [&](const Entry& entry) {
+        return entry.hash == hash && entry.key == key;
+    });
+    if (entry == m_entries.end()) {
+        return nullptr;
+    }
+
+    // mark as most recently used
+    std::rotate(entry, entry + 1, m_entries.end());
+    return &m_entries.back().hint;
+}
+
+auto HintCache::insert(HintKey key, std::optional<Hint> hint) -> void {
+    if (this->find(key) != nullptr) {
+        return;
+    }
+    if (m_entries.size() == CAPACITY) {
+        m_entries.pop_front();
+    }
+    auto hash = key.hash();
+    m_entries.push_back(Entry{ .hash = hash, .key = std::move(key), .hint = std::move(hint) });
+}
+
+auto HintCache::clear() -> void {
+    m_entries.clear();
+}
@@ -0,0 +1,89 @@
+#pragma once
+// A solver deduction translated into what the grid has to show for it.
+// Hints are computed off the GUI thread, so they own all of their data
+// and don't refer to any FFI handles.
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+#include "sudoku_ffi/sudoku.h"
+#include "hint_highlight.h"
+#include "cell_state.h"
+
+struct Hint {
+    std::array<HintHighlight, 81> cell_highlights;
+
+    // bit n is set if candidate n+1 of the cell is part of the pattern
+    std::array<uint16_t, 81> digit_highlights{};
+    // bit n is set if candidate n+1 of the cell can be removed
+    std::array<uint16_t, 81> conflict_highlights{};
+
+    // digit that can be entered, if any
+    std::optional<Candidate> candidate;
+    // candidates that can be removed
+    std::vector<Candidate> conflicts;
+
+    Hint();
+
+    auto set_house_highlight(int house, HintHighlight highlight) -> void;
+    auto set_cell_highlight(int cell, HintHighlight highlight) -> void;
+    auto set_digit_highlight(int cell, int digit, bool is_conflict) -> void;
+};
+
+// What applying a deduction does to the grid.
+struct DeductionEffects {
+    std::optional<Candidate> placement;
+    std::vector<Candidate> eliminations;
+};
+
+auto deduction_effects(const Deduction& deduction) -> DeductionEffects;
+
+// Translate a deduction of the strategy solver.
+// Deduction types that can't be displayed yet result in an empty hint.
+auto hint_from_deduction(const Deduction& deduction) -> Hint;
+
+// Hints for the deductions that the native solver makes as well, see native_solver.h.
+// `digit` is 1-based.
+auto naked_single_hint(Candidate candidate) -> Hint;
+auto hidden_single_hint(Candidate candidate, HouseType house_type) -> Hint;
+auto locked_candidates_hint(uint8_t digit, uint8_t miniline, bool is_pointing, std::vector<Candidate> conflicts)
+    -> Hint;
+
+// Find the first deduction for `grid_state` and translate it.
+// Returns nothing if no strategy applies.
+// Leading strategies that the native solver implements are tried without the FFI,
+// the strategy solver is only run if they don't find anything.
+// Blocking, meant to be called on a worker thread.
+auto compute_hint(const GridState& grid_state, const std::vector<Strategy>& strategies) -> std::optional<Hint>;
+
+// everything a hint depends on
+struct HintKey {
+    GridWidgetState grid;
+    std::vector<Strategy> strategies;
+
+    auto hash() const -> uint64_t;
+    auto operator==(const HintKey&) const -> bool = default;
+};
+
+// Recently computed hints, including the knowledge that no hint exists.
+// Lets a hint that was precomputed in the background be shown instantly.
+class HintCache {
+    static constexpr size_t CAPACITY = 32;
+
+    struct Entry {
+        uint64_t hash;
+        HintKey key;
+        std::optional<Hint> hint;
+    };
+
+    // least recently used first
+    std::deque<Entry> m_entries;
+
+public:
+    // nullptr if the key is not cached
+    auto find(const HintKey& key) -> const std::optional<Hint>*;
+    auto insert(HintKey key, std::optional<Hint> hint) -> void;
+    auto clear() -> void;
+};
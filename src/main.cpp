@@ -1,7 +1,38 @@
 #include "mainwindow.h"
+#include "puzzle_pool.h"
 #include <QApplication>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// Headless generator mode:
+//   sudoku-gui --generate <puzzles per grade> <file>
+// Fills the graded puzzle buckets on all cores and writes them to <file>,
+// in the same format as the GUI's puzzle pool.
+auto generate(int argc, char* argv[]) -> int {
+    if (argc != 4) {
+        std::fprintf(stderr, "usage: %s --generate <puzzles per grade> <file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    auto per_grade = std::strtoul(argv[2], nullptr, 10);
+    auto n_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    PuzzlePool pool(per_grade, argv[3], n_threads);
+    pool.wait_until_settled();
+
+    for (uint8_t grade = 0; grade < N_GRADES; grade++) {
+        std::printf("%-18s %zu\n", strategy_name(STRATEGIES[grade]), pool.size(grade));
+    }
+    return EXIT_SUCCESS;
+}
 
 auto main(int argc, char* argv[]) -> int {
+    if (argc > 1 && std::strcmp(argv[1], "--generate") == 0) {
+        return generate(argc, argv);
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
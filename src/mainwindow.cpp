@@ -1,12 +1,32 @@
 #include "mainwindow.h"
 #include "sudoku_grid_widget.h"
 #include "ui_mainwindow.h"
+#include "strategies.h"
+#include "profiler_overlay.h"
+#include "puzzle_browser.h"
+#include "solution_path_panel.h"
 #include <QAction>
 #include <QActionGroup>
+#include <QApplication>
+#include <QComboBox>
+#include <QDateTime>
+#include <QDockWidget>
+#include <QInputDialog>
+#include <QLineEdit>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
 
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWindow) {
     ui->setupUi(this);
 
+    // the grid paints all cells itself unless the old widget per cell is asked for
+    if (QApplication::arguments().contains("--cell-widgets")) {
+        ui->sudoku_grid->set_renderer(GridRenderer::CellWidgets);
+    }
+
     // clang-format off
     QToolButton *buttons[] = {
         ui->digit_button_off,
@@ -36,6 +56,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWi
         action->setShortcut(shortcut);
 
         button->setDefaultAction(action);
+        m_digit_actions[digit] = action;
 
         connect(action, &QAction::triggered, [this, digit]() { this->ui->sudoku_grid->highlight_digit(digit); });
     }
@@ -62,7 +83,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWi
         std::make_pair(ui->strategy_jellyfish, Strategy::Jellyfish),
     });
 
-    auto hint_strategies = [=, this]() {
+    auto checked_strategies = [=]() {
         std::vector<Strategy> strategies;
 
         for (auto& pair : button_strategies) {
@@ -74,9 +95,41 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWi
             }
         }
 
-        ui->sudoku_grid->hint(strategies);
+        return strategies;
     };
 
+    auto hint_strategies = [=, this]() { ui->sudoku_grid->hint(checked_strategies()); };
+
+    // solution path from the current grid, docked at the side and hidden until asked for
+    m_solution_path = new SolutionPathPanel(this);
+    auto* solution_path_dock = new QDockWidget("Solution Path", this);
+    solution_path_dock->setObjectName("solution_path_dock");
+    solution_path_dock->setWidget(m_solution_path);
+    this->addDockWidget(Qt::RightDockWidgetArea, solution_path_dock);
+    solution_path_dock->hide();
+
+    auto* toggle_solution_path = solution_path_dock->toggleViewAction();
+    toggle_solution_path->setShortcut(QKeySequence("Ctrl+Shift+P"));
+    ui->menu_view->addAction(toggle_solution_path);
+
+    m_solution_path->grid_changed(ui->sudoku_grid->sudoku_state());
+    connect(ui->sudoku_grid, &SudokuGridWidget::state_edited, m_solution_path, &SolutionPathPanel::grid_changed);
+    connect(m_solution_path, &SolutionPathPanel::step_activated, [this](const Hint& hint) {
+        ui->sudoku_grid->show_hint(hint);
+        ui->sudoku_grid->setFocus();
+    });
+
+    // let the grid precompute hints with the selected strategies, and search the solution path with them
+    auto update_strategies = [=, this]() {
+        auto strategies = checked_strategies();
+        ui->sudoku_grid->set_strategies(strategies);
+        m_solution_path->set_strategies(std::move(strategies));
+    };
+    for (auto& pair : button_strategies) {
+        connect(pair.first, &QToolButton::toggled, update_strategies);
+    }
+    update_strategies();
+
     // Hook up actions
     // hint
     auto hint_action = ui->action_hint;
@@ -84,17 +137,212 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWi
 
     connect(hint_action, &QAction::triggered, hint_strategies);
 
+    // several deductions at once, as a single undo step
+    connect(ui->action_apply_singles, &QAction::triggered, [this]() {
+        ui->sudoku_grid->apply_deductions({ Strategy::NakedSingles, Strategy::HiddenSingles });
+    });
+    connect(ui->action_apply_steps, &QAction::triggered, [=, this]() {
+        auto ok = false;
+        auto n_steps = QInputDialog::getInt(this, "Apply Steps", "Steps:", 5, 1, 81 * 9, 1, &ok);
+        if (ok) {
+            ui->sudoku_grid->apply_deductions(checked_strategies(), n_steps);
+        }
+    });
+
 
     // new sudoku
     connect(ui->action_new_sudoku, &QAction::triggered, [this]() { ui->sudoku_grid->generate_new_sudoku(); });
 
+    // difficulty of new sudokus, graded by the hardest strategy required
+    auto* difficulty = new QComboBox(this);
+    difficulty->setFocusPolicy(Qt::NoFocus);
+    difficulty->addItem("Any difficulty");
+    for (auto strategy : STRATEGIES) {
+        difficulty->addItem(strategy_name(strategy));
+    }
+    ui->mainToolBar->insertWidget(ui->action_copy, difficulty);
+    ui->mainToolBar->insertSeparator(ui->action_copy);
+
+    connect(difficulty, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int index) {
+        auto grade = index == 0 ? std::optional<uint8_t>() : std::optional<uint8_t>(index - 1);
+        ui->sudoku_grid->set_difficulty(grade);
+    });
+
+    // saving and loading
+    connect(ui->action_open_game, &QAction::triggered, [this]() { this->open_game(); });
+    connect(ui->action_save_game, &QAction::triggered, [this]() { this->save_game(); });
+    connect(ui->action_open_from_archive, &QAction::triggered, [this]() { this->open_from_archive(); });
+    connect(ui->action_save_to_archive, &QAction::triggered, [this]() { this->save_to_archive(); });
+    connect(ui->action_open_collection, &QAction::triggered, [this]() { this->open_collection(); });
+
     // undo
     connect(ui->action_undo, &QAction::triggered, [this]() { ui->sudoku_grid->undo(); });
 
     // redo
     connect(ui->action_redo, &QAction::triggered, [this]() { ui->sudoku_grid->redo(); });
+
+    // lines of play that were undone and then played differently
+    connect(ui->action_previous_branch, &QAction::triggered, [this]() { ui->sudoku_grid->switch_branch(-1); });
+    connect(ui->action_next_branch, &QAction::triggered, [this]() { ui->sudoku_grid->switch_branch(1); });
+
+    // result of trying a candidate with T
+    connect(ui->sudoku_grid, &SudokuGridWidget::candidate_tried, [this](Candidate candidate, bool is_contradiction) {
+        auto cell = QString("r%1c%2 = %3").arg(candidate.cell / 9 + 1).arg(candidate.cell % 9 + 1).arg(candidate.num);
+        auto message = is_contradiction ? cell + " leads to a contradiction, undo to go back"
+                                        : cell + " holds up as far as the singles go";
+        ui->statusBar->showMessage(message);
+    });
+
+    // mistakes and solution, from the brute force solver
+    connect(ui->action_show_mistakes, &QAction::toggled, [this](bool checked) {
+        ui->sudoku_grid->set_show_mistakes(checked);
+    });
+    connect(ui->action_solve, &QAction::triggered, [this]() { ui->sudoku_grid->solve(); });
+
+    // profiling, keyboard only
+    m_profiler_overlay = new ProfilerOverlay(ui->sudoku_grid->profiler(), ui->centralWidget);
+    this->addAction(ui->action_frame_timings);
+    this->addAction(ui->action_export_trace);
+
+    connect(ui->action_frame_timings, &QAction::toggled, [this](bool checked) {
+        m_profiler_overlay->setVisible(checked);
+        m_profiler_overlay->raise();
+    });
+
+    connect(ui->action_export_trace, &QAction::triggered, [this]() {
+        auto path = QFileDialog::getSaveFileName(
+            this, "Export Frame Trace", "frame_trace.json", "Chrome trace (*.json)");
+        if (path.isEmpty()) {
+            return;
+        }
+        std::ofstream file(path.toStdString());
+        ui->sudoku_grid->profiler().write_chrome_trace(file);
+        if (!file) {
+            QMessageBox::warning(this, "Export Frame Trace", "Could not write " + path);
+        }
+    });
 }
 
 MainWindow::~MainWindow() {
     delete ui;
 }
+
+namespace {
+    const QString GAME_FILTER = "Sudoku game (*.sudoku)";
+    const QString ARCHIVE_FILTER = "Sudoku game archive (*.sudokus)";
+    const QString COLLECTION_FILTER = "Puzzle collection (*.txt *.sdm)";
+}
+
+auto MainWindow::open_game() -> void {
+    auto path = QFileDialog::getOpenFileName(this, "Open Game", QString(), GAME_FILTER);
+    if (path.isEmpty()) {
+        return;
+    }
+    try {
+        this->load_game(read_game_file(path.toStdString()), path);
+    } catch (const std::exception& error) {
+        QMessageBox::warning(this, "Open Game", error.what());
+    }
+}
+
+auto MainWindow::save_game() -> void {
+    auto path = QFileDialog::getSaveFileName(this, "Save Game", "game.sudoku", GAME_FILTER);
+    if (path.isEmpty()) {
+        return;
+    }
+    try {
+        write_game_file(path.toStdString(), ui->sudoku_grid->saved_game());
+    } catch (const std::exception& error) {
+        QMessageBox::warning(this, "Save Game", error.what());
+    }
+}
+
+// Only the archive's index is read to list the games, and only the chosen game's record after that.
+auto MainWindow::open_from_archive() -> void {
+    auto path = QFileDialog::getOpenFileName(this, "Open from Archive", QString(), ARCHIVE_FILTER);
+    if (path.isEmpty()) {
+        return;
+    }
+    try {
+        GameArchive archive(path.toStdString());
+        QStringList names;
+        for (size_t game = 0; game < archive.size(); game++) {
+            auto name = archive.name(game);
+            names.append(QString::fromUtf8(name.data(), name.size()));
+        }
+
+        if (names.isEmpty()) {
+            throw std::runtime_error("The archive is empty");
+        }
+
+        auto ok = false;
+        auto name = QInputDialog::getItem(this, "Open from Archive", "Game:", names, 0, false, &ok);
+        if (!ok) {
+            return;
+        }
+        auto game = archive.load(names.indexOf(name));
+        if (!game.has_value()) {
+            throw std::runtime_error("The game is damaged");
+        }
+        this->load_game(*game, name);
+    } catch (const std::exception& error) {
+        QMessageBox::warning(this, "Open from Archive", error.what());
+    }
+}
+
+auto MainWindow::save_to_archive() -> void {
+    auto path = QFileDialog::getSaveFileName(
+        this, "Save to Archive", "games.sudokus", ARCHIVE_FILTER, nullptr, QFileDialog::DontConfirmOverwrite);
+    if (path.isEmpty()) {
+        return;
+    }
+
+    auto ok = false;
+    auto default_name = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm");
+    auto name = QInputDialog::getText(this, "Save to Archive", "Name:", QLineEdit::Normal, default_name, &ok);
+    if (!ok || name.isEmpty()) {
+        return;
+    }
+    try {
+        GameArchive::store(path.toStdString(), name.toStdString(), ui->sudoku_grid->saved_game());
+    } catch (const std::exception& error) {
+        QMessageBox::warning(this, "Save to Archive", error.what());
+    }
+}
+
+// Reopening the same file keeps its index instead of scanning it again.
+auto MainWindow::open_collection() -> void {
+    if (m_puzzle_browser == nullptr) {
+        m_puzzle_browser = new PuzzleBrowser(this);
+        connect(m_puzzle_browser, &PuzzleBrowser::puzzle_chosen, [this](Sudoku sudoku) {
+            ui->sudoku_grid->start_sudoku(sudoku);
+        });
+    }
+
+    auto* current = m_puzzle_browser->collection();
+    auto directory = current != nullptr ? QString::fromStdString(current->path()) : QString();
+    auto path = QFileDialog::getOpenFileName(this, "Open Puzzle Collection", directory, COLLECTION_FILTER);
+    if (path.isEmpty()) {
+        return;
+    }
+    if (current == nullptr || current->path() != path.toStdString()) {
+        try {
+            m_puzzle_browser->set_collection(std::make_shared<PuzzleCollection>(path.toStdString()));
+        } catch (const std::exception& error) {
+            QMessageBox::warning(this, "Open Puzzle Collection", error.what());
+            return;
+        }
+    }
+    m_puzzle_browser->show();
+    m_puzzle_browser->raise();
+    m_puzzle_browser->activateWindow();
+}
+
+// `source` names the game in error messages
+auto MainWindow::load_game(const SavedGame& game, const QString& source) -> void {
+    if (!ui->sudoku_grid->load_game(game)) {
+        QMessageBox::warning(this, "Open Game", source + " has an inconsistent history");
+        return;
+    }
+    m_digit_actions[game.highlighted_digit]->setChecked(true);
+}
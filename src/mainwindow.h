@@ -1,6 +1,13 @@
 #pragma once
 #include <QMainWindow>
+#include <QAction>
 #include <QFrame>
+#include <array>
+#include "game_file.h"
+
+class ProfilerOverlay;
+class PuzzleBrowser;
+class SolutionPathPanel;
 
 namespace Ui {
     class MainWindow;
@@ -10,6 +17,12 @@ class MainWindow : public QMainWindow {
     Q_OBJECT
 
     QFrame* m_sudoku_grid = nullptr;
+    ProfilerOverlay* m_profiler_overlay = nullptr;
+    // digit highlight actions, index 0 for no highlight
+    std::array<QAction*, 10> m_digit_actions{};
+    // created on first use, keeps the last collection open
+    PuzzleBrowser* m_puzzle_browser = nullptr;
+    SolutionPathPanel* m_solution_path = nullptr;
 
 public:
     explicit MainWindow(QWidget* parent = 0);
@@ -17,4 +30,11 @@ public:
 
 private:
     Ui::MainWindow* ui;
+
+    auto open_game() -> void;
+    auto save_game() -> void;
+    auto open_from_archive() -> void;
+    auto save_to_archive() -> void;
+    auto open_collection() -> void;
+    auto load_game(const SavedGame& game, const QString& source) -> void;
 };
@@ -0,0 +1,29 @@
+#pragma once
+// Read-only memory mapping of a whole file.
+// The OS pages the contents in on demand, nothing is copied up front.
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// how the mapping is going to be read, a hint for the OS's read-ahead
+enum class FileAccess { Sequential, Random };
+
+class MappedFile {
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+
+public:
+    // throws std::system_error if the file can't be opened or mapped
+    explicit MappedFile(const std::string& path, FileAccess access = FileAccess::Sequential);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+    MappedFile(const MappedFile&) = delete;
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+    auto data() const -> const char*;
+    auto size() const -> size_t;
+    auto view() const -> std::string_view;
+};
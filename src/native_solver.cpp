@@ -0,0 +1,314 @@
+#include "native_solver.h"
+#include "sudoku_helper.h"
+#include "sudoku_tables.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#elif defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr uint16_t ALL_DIGITS = 0x1FF;
+
+    // one 16 bit lane per house or cell, padded to a multiple of the vector width
+    using HouseLanes = std::array<uint16_t, 32>;
+    using CellLanes = std::array<uint16_t, 96>;
+
+    // the other two minilines of the same line
+    constexpr auto LINE_NEIGHBOURS = []() {
+        std::array<std::array<uint8_t, 2>, 54> neighbours{};
+        for (int miniline = 0; miniline < 54; miniline++) {
+            auto first = miniline / 3 * 3;
+            neighbours[miniline] = { static_cast<uint8_t>(first + (miniline + 1) % 3),
+                                     static_cast<uint8_t>(first + (miniline + 2) % 3) };
+        }
+        return neighbours;
+    }();
+
+    // the other two minilines of the same block that run in the same direction
+    constexpr auto BLOCK_NEIGHBOURS = []() {
+        std::array<std::array<uint8_t, 2>, 54> neighbours{};
+        for (int miniline = 0; miniline < 54; miniline++) {
+            auto first = miniline < 27 ? 0 : 27;
+            int n_neighbours = 0;
+            for (int other = first; other < first + 27; other++) {
+                if (other != miniline && BLOCK_OF_MINILINE[other] == BLOCK_OF_MINILINE[miniline]) {
+                    neighbours[miniline][n_neighbours++] = static_cast<uint8_t>(other);
+                }
+            }
+        }
+        return neighbours;
+    }();
+
+    static_assert(BLOCK_NEIGHBOURS[0] == std::array<uint8_t, 2>{ 3, 6 });
+    static_assert(BLOCK_NEIGHBOURS[27 + 4] == std::array<uint8_t, 2>{ 27 + 1, 27 + 7 });
+
+    // For each house, the digits set in at least one of its cells and those set in at least two.
+    struct HouseReduction {
+        alignas(32) HouseLanes once{};
+        alignas(32) HouseLanes twice{};
+    };
+
+    // The cells are gathered position by position, so that each step combines all 27 houses at once.
+    auto reduce_houses(const CellLanes& values) -> HouseReduction {
+        HouseReduction result;
+        for (int position = 0; position < 9; position++) {
+            alignas(32) HouseLanes lanes{};
+            for (int house = 0; house < 27; house++) {
+                lanes[house] = values[CELLS_OF_HOUSE[house][position]];
+            }
+
+#if defined(__AVX2__)
+            for (size_t i = 0; i < lanes.size(); i += 16) {
+                auto value = _mm256_load_si256(reinterpret_cast<const __m256i*>(&lanes[i]));
+                auto once = _mm256_load_si256(reinterpret_cast<const __m256i*>(&result.once[i]));
+                auto twice = _mm256_load_si256(reinterpret_cast<const __m256i*>(&result.twice[i]));
+                twice = _mm256_or_si256(twice, _mm256_and_si256(once, value));
+                once = _mm256_or_si256(once, value);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(&result.once[i]), once);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(&result.twice[i]), twice);
+            }
+#elif defined(__SSE2__)
+            for (size_t i = 0; i < lanes.size(); i += 8) {
+                auto value = _mm_load_si128(reinterpret_cast<const __m128i*>(&lanes[i]));
+                auto once = _mm_load_si128(reinterpret_cast<const __m128i*>(&result.once[i]));
+                auto twice = _mm_load_si128(reinterpret_cast<const __m128i*>(&result.twice[i]));
+                twice = _mm_or_si128(twice, _mm_and_si128(once, value));
+                once = _mm_or_si128(once, value);
+                _mm_store_si128(reinterpret_cast<__m128i*>(&result.once[i]), once);
+                _mm_store_si128(reinterpret_cast<__m128i*>(&result.twice[i]), twice);
+            }
+#else
+            for (int house = 0; house < 27; house++) {
+                result.twice[house] |= result.once[house] & lanes[house];
+                result.once[house] |= lanes[house];
+            }
+#endif
+        }
+        return result;
+    }
+
+    // first cell with exactly one candidate, -1 if there is none
+    auto first_naked_single(const CellLanes& candidates) -> int {
+#if defined(__AVX2__)
+        auto zero = _mm256_setzero_si256();
+        auto one = _mm256_set1_epi16(1);
+        for (size_t i = 0; i < candidates.size(); i += 16) {
+            auto value = _mm256_load_si256(reinterpret_cast<const __m256i*>(&candidates[i]));
+            auto lowest_cleared = _mm256_and_si256(value, _mm256_sub_epi16(value, one));
+            auto is_power_of_two = _mm256_cmpeq_epi16(lowest_cleared, zero);
+            auto is_single = _mm256_andnot_si256(_mm256_cmpeq_epi16(value, zero), is_power_of_two);
+            // two mask bits per lane
+            auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(is_single));
+            if (mask != 0) {
+                return static_cast<int>(i) + std::countr_zero(mask) / 2;
+            }
+        }
+        return -1;
+#elif defined(__SSE2__)
+        auto zero = _mm_setzero_si128();
+        auto one = _mm_set1_epi16(1);
+        for (size_t i = 0; i < candidates.size(); i += 8) {
+            auto value = _mm_load_si128(reinterpret_cast<const __m128i*>(&candidates[i]));
+            auto lowest_cleared = _mm_and_si128(value, _mm_sub_epi16(value, one));
+            auto is_power_of_two = _mm_cmpeq_epi16(lowest_cleared, zero);
+            auto is_single = _mm_andnot_si128(_mm_cmpeq_epi16(value, zero), is_power_of_two);
+            // two mask bits per lane
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(is_single));
+            if (mask != 0) {
+                return static_cast<int>(i) + std::countr_zero(mask) / 2;
+            }
+        }
+        return -1;
+#else
+        for (int cell = 0; cell < 81; cell++) {
+            if (std::has_single_bit(candidates[cell])) {
+                return cell;
+            }
+        }
+        return -1;
+#endif
+    }
+
+    // bit n is digit n+1 everywhere
+    struct Board {
+        // the digit of filled cells, 0 for unfilled ones
+        alignas(32) CellLanes digits{};
+        // the candidates of unfilled cells minus the digits placed in their houses, 0 for filled ones
+        alignas(32) CellLanes candidates{};
+        // digits placed in each house
+        HouseLanes placed{};
+        // candidates of each house
+        HouseReduction possible;
+        bool is_contradictory = false;
+    };
+
+    // A board is contradictory if a house contains a digit twice, a cell has no candidates left
+    // or a digit can go nowhere in a house.
+    auto read_board(const GridState& grid_state) -> Board {
+        Board board;
+        CellLanes entered_candidates{};
+        for (int cell = 0; cell < 81; cell++) {
+            const auto& cell_state = grid_state.grid[cell];
+            if (cell_state.tag == CellState::Tag::Digit) {
+                auto digit = cell_state.digit._0;
+                if (digit < 1 || digit > 9) {
+                    board.is_contradictory = true;
+                    return board;
+                }
+                board.digits[cell] = static_cast<uint16_t>(1u << (digit - 1));
+            } else {
+                entered_candidates[cell] = cell_state.candidates._0 & ALL_DIGITS;
+            }
+        }
+
+        auto placed = reduce_houses(board.digits);
+        board.placed = placed.once;
+        for (int house = 0; house < 27; house++) {
+            board.is_contradictory |= placed.twice[house] != 0;
+        }
+
+        for (int cell = 0; cell < 81; cell++) {
+            if (board.digits[cell] != 0) {
+                continue;
+            }
+            auto [row, col, block] = HOUSES_OF_CELL[cell];
+            auto blocked = board.placed[row] | board.placed[col] | board.placed[block];
+            board.candidates[cell] = entered_candidates[cell] & ~blocked;
+            board.is_contradictory |= board.candidates[cell] == 0;
+        }
+
+        board.possible = reduce_houses(board.candidates);
+        for (int house = 0; house < 27; house++) {
+            board.is_contradictory |= (board.placed[house] | board.possible.once[house]) != ALL_DIGITS;
+        }
+        return board;
+    }
+
+    auto lowest_digit(uint16_t digits) -> uint8_t {
+        return static_cast<uint8_t>(std::countr_zero(digits) + 1);
+    }
+
+    auto find_naked_single(const Board& board) -> std::optional<Hint> {
+        auto cell = first_naked_single(board.candidates);
+        if (cell < 0) {
+            return {};
+        }
+        auto candidate = Candidate{ static_cast<uint8_t>(cell), lowest_digit(board.candidates[cell]) };
+        return naked_single_hint(candidate);
+    }
+
+    auto find_hidden_single(const Board& board) -> std::optional<Hint> {
+        for (int house = 0; house < 27; house++) {
+            uint16_t exactly_once = board.possible.once[house] & ~board.possible.twice[house];
+            if (exactly_once == 0) {
+                continue;
+            }
+            auto digit = lowest_digit(exactly_once);
+            for (auto cell : CELLS_OF_HOUSE[house]) {
+                if ((board.candidates[cell] >> (digit - 1) & 1) != 0) {
+                    return hidden_single_hint(Candidate{ cell, digit }, house_type(house));
+                }
+            }
+        }
+        return {};
+    }
+
+    // A digit that is confined to a miniline within its block can't be anywhere else in the line (pointing)
+    // and a digit confined to a miniline within its line can't be anywhere else in the block (claiming).
+    auto find_locked_candidates(const Board& board) -> std::optional<Hint> {
+        std::array<uint16_t, 54> miniline_candidates{};
+        for (int miniline = 0; miniline < 54; miniline++) {
+            for (auto cell : CELLS_OF_MINILINE[miniline]) {
+                miniline_candidates[miniline] |= board.candidates[cell];
+            }
+        }
+
+        auto union_of = [&](const std::array<uint8_t, 2>& minilines) -> uint16_t {
+            return miniline_candidates[minilines[0]] | miniline_candidates[minilines[1]];
+        };
+
+        auto conflicts_in = [&](const std::array<uint8_t, 2>& minilines, uint8_t digit) {
+            std::vector<Candidate> conflicts;
+            for (auto miniline : minilines) {
+                for (auto cell : CELLS_OF_MINILINE[miniline]) {
+                    if ((board.candidates[cell] >> (digit - 1) & 1) != 0) {
+                        conflicts.push_back(Candidate{ cell, digit });
+                    }
+                }
+            }
+            std::sort(conflicts.begin(), conflicts.end(), [](Candidate a, Candidate b) { return a.cell < b.cell; });
+            return conflicts;
+        };
+
+        for (int miniline = 0; miniline < 54; miniline++) {
+            auto line_rest = union_of(LINE_NEIGHBOURS[miniline]);
+            auto block_rest = union_of(BLOCK_NEIGHBOURS[miniline]);
+            auto candidates = miniline_candidates[miniline];
+
+            uint16_t pointing = candidates & ~block_rest & line_rest;
+            if (pointing != 0) {
+                auto digit = lowest_digit(pointing);
+                auto conflicts = conflicts_in(LINE_NEIGHBOURS[miniline], digit);
+                return locked_candidates_hint(digit, static_cast<uint8_t>(miniline), true, std::move(conflicts));
+            }
+
+            uint16_t claiming = candidates & ~line_rest & block_rest;
+            if (claiming != 0) {
+                auto digit = lowest_digit(claiming);
+                auto conflicts = conflicts_in(BLOCK_NEIGHBOURS[miniline], digit);
+                return locked_candidates_hint(digit, static_cast<uint8_t>(miniline), false, std::move(conflicts));
+            }
+        }
+        return {};
+    }
+}
+
+auto is_native_strategy(Strategy strategy) -> bool {
+    switch (strategy) {
+        case Strategy::NakedSingles:
+        case Strategy::HiddenSingles:
+        case Strategy::LockedCandidates:
+            return true;
+        default:
+            return false;
+    }
+}
+
+auto native_hint(const GridState& grid_state, std::span<const Strategy> strategies) -> NativeHintResult {
+    auto inconclusive = NativeHintResult{ .is_conclusive = false, .hint = {} };
+    if (!strategies.empty() && !is_native_strategy(strategies.front())) {
+        return inconclusive;
+    }
+
+    auto board = read_board(grid_state);
+    if (board.is_contradictory) {
+        return inconclusive;
+    }
+
+    for (auto strategy : strategies) {
+        std::optional<Hint> hint;
+        switch (strategy) {
+            case Strategy::NakedSingles:
+                hint = find_naked_single(board);
+                break;
+            case Strategy::HiddenSingles:
+                hint = find_hidden_single(board);
+                break;
+            case Strategy::LockedCandidates:
+                hint = find_locked_candidates(board);
+                break;
+            default:
+                return inconclusive;
+        }
+        if (hint.has_value()) {
+            return { .is_conclusive = true, .hint = std::move(hint) };
+        }
+    }
+    return { .is_conclusive = true, .hint = {} };
+}
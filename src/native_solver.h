@@ -0,0 +1,22 @@
+#pragma once
+// Naked singles, hidden singles and locked candidates without a round trip through the FFI.
+// These are what nearly every hint request ends up finding, so they are worth doing in C++.
+// The candidates of all houses are reduced at once with SSE2 or AVX2 where available.
+
+#include <optional>
+#include <span>
+#include "sudoku_ffi/sudoku.h"
+#include "hint.h"
+
+auto is_native_strategy(Strategy strategy) -> bool;
+
+struct NativeHintResult {
+    // If false, the strategy solver has to decide.
+    bool is_conclusive;
+    std::optional<Hint> hint;
+};
+
+// Try `strategies` in order for as long as they are native.
+// Conclusive if one of them applies or if all of them are native and none applies.
+// Grids with contradictions are always left to the strategy solver.
+auto native_hint(const GridState& grid_state, std::span<const Strategy> strategies) -> NativeHintResult;
@@ -0,0 +1,64 @@
+#include "profiler_overlay.h"
+#include <QFontDatabase>
+
+const int REFRESH_INTERVAL_MS = 500;
+
+ProfilerOverlay::ProfilerOverlay(const FrameProfiler& profiler, QWidget* parent)
+    : QLabel(parent), m_profiler(profiler) {
+    this->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    this->setMargin(6);
+    this->setAttribute(Qt::WA_TransparentForMouseEvents);
+
+    // opaque, so refreshing it doesn't make the cells below repaint and skew the numbers
+    QPalette pal = palette();
+    pal.setColor(QPalette::Window, QColor(255, 255, 224)); // light yellow
+    this->setAutoFillBackground(true);
+    this->setPalette(pal);
+
+    m_refresh_timer.setInterval(REFRESH_INTERVAL_MS);
+    connect(&m_refresh_timer, &QTimer::timeout, this, &ProfilerOverlay::refresh);
+    this->hide();
+}
+
+auto ProfilerOverlay::showEvent(QShowEvent* event) -> void {
+    this->refresh();
+    m_refresh_timer.start();
+    QLabel::showEvent(event);
+}
+
+auto ProfilerOverlay::hideEvent(QHideEvent* event) -> void {
+    m_refresh_timer.stop();
+    QLabel::hideEvent(event);
+}
+
+auto ProfilerOverlay::refresh() -> void {
+    auto samples = m_profiler.snapshot();
+    auto ms = [](uint64_t ns) { return ns / 1e6; };
+
+    auto text = QString::asprintf("%-13s %6s %8s %8s", "", "n", "p50 ms", "p99 ms");
+    for (size_t event = 0; event < N_PROFILE_EVENTS; event++) {
+        auto name = profile_event_name(static_cast<ProfileEvent>(event));
+        auto summary = FrameProfiler::summarize(samples, static_cast<ProfileEvent>(event));
+        if (summary.has_value()) {
+            text += QString::asprintf(
+                "\n%-13s %6zu %8.3f %8.3f", name, summary->n_samples, ms(summary->p50_ns), ms(summary->p99_ns));
+        } else {
+            text += QString::asprintf("\n%-13s %6d %8s %8s", name, 0, "-", "-");
+        }
+    }
+
+    // the bindings can't release handles, so these only ever grow
+    auto handles = ffi_handle_counts();
+    text += QString::asprintf(
+        "\n\n%-13s %6llu\n%-13s %6llu",
+        "Solvers",
+        static_cast<unsigned long long>(handles.solvers),
+        "Solve results",
+        static_cast<unsigned long long>(handles.solve_results));
+
+    // setText repaints even if nothing changed
+    if (text != this->text()) {
+        this->setText(text);
+        this->adjustSize();
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+// Floating table of the frame profiler's p50/p99 timings, refreshed while it's visible.
+// Below it, how many solver handles have been made so far.
+
+#include <QLabel>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <QTimer>
+#include "frame_profiler.h"
+#include "ffi_handles.h"
+
+class ProfilerOverlay final : public QLabel {
+    Q_OBJECT
+
+    const FrameProfiler& m_profiler;
+    QTimer m_refresh_timer;
+
+    auto refresh() -> void;
+
+public:
+    ProfilerOverlay(const FrameProfiler& profiler, QWidget* parent);
+
+    auto showEvent(QShowEvent* event) -> void override;
+    auto hideEvent(QHideEvent* event) -> void override;
+};
@@ -0,0 +1,153 @@
+#include "puzzle_browser.h"
+#include <QDialogButtonBox>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <climits>
+
+const int REFRESH_INTERVAL_MS = 250;
+
+auto PuzzleListModel::set_collection(std::shared_ptr<const PuzzleCollection> collection) -> void {
+    this->beginResetModel();
+    m_collection = std::move(collection);
+    m_n_rows = 0;
+    this->endResetModel();
+    this->refresh();
+}
+
+auto PuzzleListModel::refresh() -> void {
+    if (m_collection == nullptr) {
+        return;
+    }
+    auto n_rows = static_cast<int>(std::min<size_t>(m_collection->size(), INT_MAX));
+    if (n_rows == m_n_rows) {
+        return;
+    }
+    this->beginInsertRows(QModelIndex(), m_n_rows, n_rows - 1);
+    m_n_rows = n_rows;
+    this->endInsertRows();
+}
+
+auto PuzzleListModel::rowCount(const QModelIndex& parent) const -> int {
+    return parent.isValid() ? 0 : m_n_rows;
+}
+
+// numbered from 1, like the jump box
+auto PuzzleListModel::data(const QModelIndex& index, int role) const -> QVariant {
+    if (role != Qt::DisplayRole || !index.isValid() || m_collection == nullptr) {
+        return {};
+    }
+    auto line = m_collection->line(index.row());
+    if (!line.has_value()) {
+        return {};
+    }
+    auto puzzle = QString::fromLatin1(line->data(), 81);
+    return QString("%1  %2").arg(index.row() + 1, 8).arg(puzzle);
+}
+
+PuzzleBrowser::PuzzleBrowser(QWidget* parent)
+    : QDialog(parent),
+      m_model(new PuzzleListModel(this)),
+      m_list(new QListView(this)),
+      m_jump(new QSpinBox(this)),
+      m_status(new QLabel(this)) {
+    this->setWindowTitle("Puzzle Collection");
+    this->resize(780, 480);
+
+    m_list->setModel(m_model);
+    m_list->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    // lets the view skip measuring every row
+    m_list->setUniformItemSizes(true);
+    m_list->setSelectionMode(QAbstractItemView::SingleSelection);
+    connect(m_list, &QListView::activated, this, &PuzzleBrowser::choose);
+
+    m_jump->setMinimum(1);
+    connect(m_jump, QOverload<int>::of(&QSpinBox::valueChanged), this, &PuzzleBrowser::jump_to);
+
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    auto* play = buttons->addButton("Play", QDialogButtonBox::AcceptRole);
+    play->setDefault(true);
+    connect(buttons, &QDialogButtonBox::accepted, this, &PuzzleBrowser::choose);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    auto* jump_row = new QHBoxLayout();
+    jump_row->addWidget(new QLabel("Go to puzzle", this));
+    jump_row->addWidget(m_jump);
+    jump_row->addStretch();
+    jump_row->addWidget(m_status);
+
+    auto* layout = new QVBoxLayout(this);
+    layout->addLayout(jump_row);
+    layout->addWidget(m_list);
+    layout->addWidget(buttons);
+
+    m_refresh_timer.setInterval(REFRESH_INTERVAL_MS);
+    connect(&m_refresh_timer, &QTimer::timeout, this, &PuzzleBrowser::refresh);
+}
+
+auto PuzzleBrowser::set_collection(std::shared_ptr<const PuzzleCollection> collection) -> void {
+    m_collection = std::move(collection);
+    m_model->set_collection(m_collection);
+    this->setWindowTitle(QFileInfo(QString::fromStdString(m_collection->path())).fileName());
+    this->refresh();
+    this->jump_to(1);
+}
+
+auto PuzzleBrowser::collection() const -> const PuzzleCollection* {
+    return m_collection.get();
+}
+
+// the index grows in the background, only poll while it can be seen
+auto PuzzleBrowser::showEvent(QShowEvent* event) -> void {
+    this->refresh();
+    m_refresh_timer.start();
+    QDialog::showEvent(event);
+}
+
+auto PuzzleBrowser::hideEvent(QHideEvent* event) -> void {
+    m_refresh_timer.stop();
+    QDialog::hideEvent(event);
+}
+
+auto PuzzleBrowser::refresh() -> void {
+    if (m_collection == nullptr) {
+        return;
+    }
+    m_model->refresh();
+    auto n_puzzles = m_model->rowCount(QModelIndex());
+    m_jump->setMaximum(std::max(n_puzzles, 1));
+
+    auto status = QString("%1 puzzles").arg(n_puzzles);
+    if (m_collection->is_complete()) {
+        // nothing left to poll for
+        m_refresh_timer.stop();
+    } else {
+        status += ", indexing...";
+    }
+    m_status->setText(status);
+}
+
+auto PuzzleBrowser::jump_to(int number) -> void {
+    auto index = m_model->index(number - 1);
+    if (!index.isValid()) {
+        return;
+    }
+    m_list->setCurrentIndex(index);
+    m_list->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+auto PuzzleBrowser::choose() -> void {
+    auto index = m_list->currentIndex();
+    if (m_collection == nullptr || !index.isValid()) {
+        return;
+    }
+    auto sudoku = m_collection->puzzle(index.row());
+    if (!sudoku.has_value()) {
+        return;
+    }
+    emit puzzle_chosen(*sudoku);
+    this->accept();
+}
@@ -0,0 +1,58 @@
+#pragma once
+// Dialog for picking a puzzle out of a collection, usable while the collection is still being indexed.
+// The list only asks for the rows that are on screen, so its size doesn't matter.
+
+#include <QAbstractListModel>
+#include <QDialog>
+#include <QHideEvent>
+#include <QLabel>
+#include <QListView>
+#include <QShowEvent>
+#include <QSpinBox>
+#include <QTimer>
+#include <memory>
+#include "puzzle_collection.h"
+
+class PuzzleListModel final : public QAbstractListModel {
+    Q_OBJECT
+
+    std::shared_ptr<const PuzzleCollection> m_collection;
+    int m_n_rows = 0;
+
+public:
+    using QAbstractListModel::QAbstractListModel;
+
+    auto set_collection(std::shared_ptr<const PuzzleCollection> collection) -> void;
+    // Add the rows for the puzzles indexed since the last call.
+    auto refresh() -> void;
+
+    auto rowCount(const QModelIndex& parent) const -> int override;
+    auto data(const QModelIndex& index, int role) const -> QVariant override;
+};
+
+class PuzzleBrowser final : public QDialog {
+    Q_OBJECT
+
+    std::shared_ptr<const PuzzleCollection> m_collection;
+    PuzzleListModel* m_model;
+    QListView* m_list;
+    QSpinBox* m_jump;
+    QLabel* m_status;
+    QTimer m_refresh_timer;
+
+    auto refresh() -> void;
+    auto jump_to(int number) -> void;
+    auto choose() -> void;
+
+public:
+    explicit PuzzleBrowser(QWidget* parent);
+
+    auto set_collection(std::shared_ptr<const PuzzleCollection> collection) -> void;
+    auto collection() const -> const PuzzleCollection*;
+
+    auto showEvent(QShowEvent* event) -> void override;
+    auto hideEvent(QHideEvent* event) -> void override;
+
+signals:
+    void puzzle_chosen(Sudoku sudoku);
+};
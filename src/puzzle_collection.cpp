@@ -0,0 +1,94 @@
+#include "puzzle_collection.h"
+#include "puzzle_format.h"
+#include <algorithm>
+
+PuzzleCollection::PuzzleCollection(std::string path)
+    : m_path(std::move(path)), m_file(m_path), m_indexer([this]() { this->build_index(); }) {}
+
+PuzzleCollection::~PuzzleCollection() {
+    m_stopping = true;
+    m_indexer.join();
+}
+
+// indexer thread
+// the lines are scanned in chunks that end on a line break,
+// each chunk's puzzles are published at once to keep the lock out of the loop
+auto PuzzleCollection::build_index() -> void {
+    auto text = m_file.view();
+    size_t chunk_begin = 0;
+    size_t n_puzzles = 0;
+    std::vector<uint64_t> chunk_index;
+
+    while (chunk_begin < text.size() && !m_stopping) {
+        auto chunk_end = std::min(chunk_begin + SCAN_CHUNK_SIZE, text.size());
+        auto line_break = text.find('\n', chunk_end);
+        chunk_end = line_break == std::string_view::npos ? text.size() : line_break + 1;
+
+        chunk_index.clear();
+        foreach_line(text.substr(chunk_begin, chunk_end - chunk_begin), [&](std::string_view line) {
+            if (!parse_puzzle(line).has_value()) {
+                return;
+            }
+            if (n_puzzles % INDEX_STRIDE == 0) {
+                chunk_index.push_back(line.data() - text.data());
+            }
+            n_puzzles++;
+        });
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_index.insert(m_index.end(), chunk_index.begin(), chunk_index.end());
+            m_n_puzzles = n_puzzles;
+        }
+        chunk_begin = chunk_end;
+    }
+    m_is_complete = !m_stopping;
+}
+
+auto PuzzleCollection::path() const -> const std::string& {
+    return m_path;
+}
+
+auto PuzzleCollection::size() const -> size_t {
+    std::lock_guard lock(m_mutex);
+    return m_n_puzzles;
+}
+
+auto PuzzleCollection::is_complete() const -> bool {
+    return m_is_complete;
+}
+
+// from the nearest indexed puzzle, skip ahead the remaining puzzle lines
+auto PuzzleCollection::line(size_t n) const -> std::optional<std::string_view> {
+    uint64_t offset;
+    {
+        std::lock_guard lock(m_mutex);
+        if (n >= m_n_puzzles) {
+            return {};
+        }
+        offset = m_index[n / INDEX_STRIDE];
+    }
+
+    auto remaining = n % INDEX_STRIDE;
+    std::optional<std::string_view> result;
+    foreach_line(m_file.view().substr(offset), [&](std::string_view line) {
+        if (!parse_puzzle(line).has_value()) {
+            return true;
+        }
+        if (remaining == 0) {
+            result = line;
+            return false;
+        }
+        remaining--;
+        return true;
+    });
+    return result;
+}
+
+auto PuzzleCollection::puzzle(size_t n) const -> std::optional<Sudoku> {
+    auto line = this->line(n);
+    if (!line.has_value()) {
+        return {};
+    }
+    return parse_puzzle(*line);
+}
@@ -0,0 +1,56 @@
+#pragma once
+// A memory-mapped puzzle collection in the 81 characters per line format (see puzzle_format.h),
+// possibly gigabytes of it. A background thread scans it once for the puzzle lines and keeps
+// the offset of every INDEX_STRIDE-th puzzle, so the index stays small and any puzzle is
+// found by scanning at most that many lines. Nothing is copied, lines are parsed straight from the mapping.
+// Lines that aren't puzzles, such as comments, are skipped and don't count.
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "sudoku_ffi/sudoku.h"
+#include "mapped_file.h"
+
+class PuzzleCollection {
+    static constexpr size_t INDEX_STRIDE = 64;
+    // published to readers in chunks of about this many bytes
+    static constexpr size_t SCAN_CHUNK_SIZE = 16 << 20;
+
+    const std::string m_path;
+    MappedFile m_file;
+
+    mutable std::mutex m_mutex;
+    // offset of puzzle n * INDEX_STRIDE
+    std::vector<uint64_t> m_index;
+    size_t m_n_puzzles = 0;
+
+    std::atomic<bool> m_is_complete = false;
+    std::atomic<bool> m_stopping = false;
+    // last, so it starts after everything else is initialized
+    std::thread m_indexer;
+
+    auto build_index() -> void;
+
+public:
+    // Starts indexing. Throws std::system_error if the file can't be mapped.
+    explicit PuzzleCollection(std::string path);
+    ~PuzzleCollection();
+
+    PuzzleCollection(const PuzzleCollection&) = delete;
+    auto operator=(const PuzzleCollection&) -> PuzzleCollection& = delete;
+
+    auto path() const -> const std::string&;
+
+    // puzzles found so far
+    auto size() const -> size_t;
+    auto is_complete() const -> bool;
+
+    // The line of puzzle `n`, nothing if it hasn't been indexed (yet).
+    auto line(size_t n) const -> std::optional<std::string_view>;
+    auto puzzle(size_t n) const -> std::optional<Sudoku>;
+};
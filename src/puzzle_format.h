@@ -0,0 +1,64 @@
+#pragma once
+// The common plain text format for sudokus: one puzzle per line,
+// 81 characters in row-major order, 1-9 for clues and 0 or . for empty cells.
+// SDM files are the same thing under a different name.
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "sudoku_ffi/sudoku.h"
+
+// Parse the first 81 characters of `line`, anything after them is ignored.
+inline auto parse_puzzle(std::string_view line) -> std::optional<Sudoku> {
+    if (line.size() < 81) {
+        return {};
+    }
+
+    Sudoku sudoku{};
+    for (int cell = 0; cell < 81; cell++) {
+        auto ch = line[cell];
+        if ('1' <= ch && ch <= '9') {
+            sudoku._0[cell] = ch - '0';
+        } else if (ch != '0' && ch != '.') {
+            return {};
+        }
+    }
+    return sudoku;
+}
+
+// 81 characters, . for empty cells
+inline auto format_puzzle(std::span<const uint8_t, 81> digits) -> std::string {
+    std::string line(81, '.');
+    for (int cell = 0; cell < 81; cell++) {
+        if (digits[cell] != 0) {
+            line[cell] = '0' + digits[cell];
+        }
+    }
+    return line;
+}
+
+// Call `f` with every line of `text` without copying, line endings stripped.
+// If `f` returns a bool, false stops the iteration.
+template <typename F>
+auto foreach_line(std::string_view text, F f) -> void {
+    while (!text.empty()) {
+        auto end = text.find('\n');
+        auto line = text.substr(0, end);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if constexpr (std::is_same_v<std::invoke_result_t<F&, std::string_view>, bool>) {
+            if (!f(line)) {
+                break;
+            }
+        } else {
+            f(line);
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(end + 1);
+    }
+}
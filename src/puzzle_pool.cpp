@@ -0,0 +1,209 @@
+#include "puzzle_pool.h"
+#include "brute_force.h"
+#include "grading.h"
+#include <fstream>
+#include <sstream>
+
+PuzzlePool::PuzzlePool(size_t capacity, std::string path, unsigned n_workers)
+    : m_capacity(capacity), m_path(std::move(path)), m_workers(std::make_unique<WorkStealingPool>(n_workers)) {
+    this->load();
+
+    std::lock_guard lock(m_mutex);
+    this->schedule();
+}
+
+PuzzlePool::~PuzzlePool() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_workers.reset();
+    this->save();
+}
+
+auto PuzzlePool::wants_more() const -> bool {
+    if (m_stopping || m_fruitless_attempts >= MAX_FRUITLESS_ATTEMPTS) {
+        return false;
+    }
+    for (const auto& bucket : m_buckets) {
+        if (bucket.size() < m_capacity) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// keep one generation per worker going while there is room
+// must be called with m_mutex held
+auto PuzzlePool::schedule() -> void {
+    while (this->wants_more() && m_in_flight < m_workers->n_threads()) {
+        m_in_flight++;
+        m_workers->submit([this]() { this->generate_one(); });
+    }
+}
+
+// worker task
+// generating and grading happens outside of the lock, it takes a while
+// the brute force check is cheap next to that and keeps a generator bug from reaching the player
+auto PuzzlePool::generate_one() -> void {
+    auto sudoku = sudoku_generate_unique();
+    auto grade = unique_solution(sudoku).has_value() ? grade_sudoku(sudoku) : std::nullopt;
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_in_flight--;
+        if (grade.has_value() && m_buckets[*grade].size() < m_capacity) {
+            m_buckets[*grade].push_back(sudoku);
+            m_fruitless_attempts = 0;
+        } else {
+            m_fruitless_attempts++;
+        }
+        this->schedule();
+    }
+    m_progress.notify_all();
+}
+
+auto PuzzlePool::take(std::optional<uint8_t> grade) -> std::optional<Sudoku> {
+    std::lock_guard lock(m_mutex);
+
+    std::deque<Sudoku>* bucket = nullptr;
+    if (grade.has_value()) {
+        // search outwards from the requested grade
+        for (int distance = 0; distance < static_cast<int>(N_GRADES) && bucket == nullptr; distance++) {
+            for (int candidate : { *grade - distance, *grade + distance }) {
+                if (0 <= candidate && candidate < static_cast<int>(N_GRADES) && !m_buckets[candidate].empty()) {
+                    bucket = &m_buckets[candidate];
+                    break;
+                }
+            }
+        }
+    } else {
+        for (auto& candidate : m_buckets) {
+            if (bucket == nullptr || candidate.size() > bucket->size()) {
+                bucket = &candidate;
+            }
+        }
+    }
+
+    if (bucket == nullptr || bucket->empty()) {
+        return {};
+    }
+    auto sudoku = bucket->front();
+    bucket->pop_front();
+
+    m_fruitless_attempts = 0;
+    this->schedule();
+    return sudoku;
+}
+
+// must be called with m_mutex held
+auto PuzzlePool::has_puzzle(std::optional<uint8_t> grade) const -> bool {
+    if (grade.has_value()) {
+        return !m_buckets[*grade].empty();
+    }
+    for (const auto& bucket : m_buckets) {
+        if (!bucket.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+auto PuzzlePool::size(uint8_t grade) const -> size_t {
+    std::lock_guard lock(m_mutex);
+    return m_buckets[grade].size();
+}
+
+// a puzzle the strategies can't solve only comes back if nothing else came up
+auto PuzzlePool::generate(std::optional<uint8_t> grade, size_t max_attempts, const std::atomic<bool>& cancelled)
+    -> std::optional<Sudoku> {
+    std::optional<Sudoku> ungraded;
+    for (size_t attempt = 0; attempt < max_attempts; attempt++) {
+        if (cancelled) {
+            return {};
+        }
+        {
+            std::lock_guard lock(m_mutex);
+            if (this->has_puzzle(grade)) {
+                break;
+            }
+        }
+
+        auto sudoku = sudoku_generate_unique();
+        if (!unique_solution(sudoku).has_value()) {
+            continue;
+        }
+        auto sudoku_grade = grade_sudoku(sudoku);
+        if (!sudoku_grade.has_value()) {
+            ungraded = sudoku;
+            continue;
+        }
+        if (!grade.has_value() || *sudoku_grade == *grade) {
+            return sudoku;
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_buckets[*sudoku_grade].size() < m_capacity) {
+                m_buckets[*sudoku_grade].push_back(sudoku);
+            }
+        }
+        m_progress.notify_all();
+    }
+
+    if (cancelled) {
+        return {};
+    }
+    auto closest = this->take(grade);
+    return closest.has_value() ? closest : ungraded;
+}
+
+auto PuzzlePool::wait_until_settled() -> void {
+    std::unique_lock lock(m_mutex);
+    m_progress.wait(lock, [this]() { return m_in_flight == 0 && !this->wants_more(); });
+}
+
+// one puzzle per line: the grade, a space and 81 digits, 0 for empty cells
+// lines that don't parse are skipped
+auto PuzzlePool::load() -> void {
+    if (m_path.empty()) {
+        return;
+    }
+    std::ifstream file(m_path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        unsigned grade;
+        std::string digits;
+        if (!(fields >> grade >> digits) || grade >= N_GRADES || digits.size() != 81) {
+            continue;
+        }
+
+        Sudoku sudoku{};
+        auto valid = true;
+        for (int cell = 0; cell < 81; cell++) {
+            auto ch = digits[cell];
+            valid &= '0' <= ch && ch <= '9';
+            sudoku._0[cell] = ch - '0';
+        }
+        if (valid && m_buckets[grade].size() < m_capacity) {
+            m_buckets[grade].push_back(sudoku);
+        }
+    }
+}
+
+auto PuzzlePool::save() const -> void {
+    if (m_path.empty()) {
+        return;
+    }
+    std::ofstream file(m_path, std::ios::trunc);
+    for (size_t grade = 0; grade < N_GRADES; grade++) {
+        for (const auto& sudoku : m_buckets[grade]) {
+            std::string digits(81, '0');
+            for (int cell = 0; cell < 81; cell++) {
+                digits[cell] = '0' + sudoku._0[cell];
+            }
+            file << grade << ' ' << digits << '\n';
+        }
+    }
+}
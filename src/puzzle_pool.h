@@ -0,0 +1,68 @@
+#pragma once
+// A stock of pre-generated sudokus, sorted into one bucket per grade,
+// that a farm of background threads keeps filled. Starting a new game
+// never has to wait for the generator.
+// The stock is written to disk on destruction and read back on construction.
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include "sudoku_ffi/sudoku.h"
+#include "strategies.h"
+#include "work_stealing_pool.h"
+
+class PuzzlePool {
+    // Hard grades are rare. After this many generated puzzles in a row
+    // that found no room in any bucket, the farm pauses until a puzzle is taken.
+    static constexpr size_t MAX_FRUITLESS_ATTEMPTS = 2000;
+
+    // per bucket
+    const size_t m_capacity;
+    // file the pool is persisted to, empty for none
+    const std::string m_path;
+
+    mutable std::mutex m_mutex;
+    // signalled whenever a generated puzzle was filed away or dropped
+    std::condition_variable m_progress;
+    std::array<std::deque<Sudoku>, N_GRADES> m_buckets;
+    size_t m_in_flight = 0;
+    size_t m_fruitless_attempts = 0;
+    bool m_stopping = false;
+
+    // destroyed first, so no task outlives the buckets
+    std::unique_ptr<WorkStealingPool> m_workers;
+
+    auto wants_more() const -> bool;
+    auto has_puzzle(std::optional<uint8_t> grade) const -> bool;
+    auto schedule() -> void;
+    auto generate_one() -> void;
+    auto load() -> void;
+    auto save() const -> void;
+
+public:
+    PuzzlePool(size_t capacity, std::string path, unsigned n_workers);
+    ~PuzzlePool();
+
+    PuzzlePool(const PuzzlePool&) = delete;
+    auto operator=(const PuzzlePool&) -> PuzzlePool& = delete;
+
+    // Take a puzzle of the given grade out of the pool or, if that bucket is empty,
+    // one of the closest grade available. Any grade if none is given.
+    auto take(std::optional<uint8_t> grade) -> std::optional<Sudoku>;
+    auto size(uint8_t grade) const -> size_t;
+
+    // For when `take` came back empty: generate on the calling thread until a puzzle of the given grade
+    // comes up, here or from the farm. Puzzles of other grades are filed away. After `max_attempts`,
+    // the closest grade in the pool. Nothing once `cancelled` is set, which is checked on every attempt.
+    auto generate(std::optional<uint8_t> grade, size_t max_attempts, const std::atomic<bool>& cancelled)
+        -> std::optional<Sudoku>;
+
+    // Block until every bucket is full or the farm gave up on the rest.
+    auto wait_until_settled() -> void;
+};
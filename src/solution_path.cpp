@@ -0,0 +1,206 @@
+#include "solution_path.h"
+#include "ffi_handles.h"
+#include "native_solver.h"
+#include "sudoku_helper.h"
+#include "sudoku_tables.h"
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+namespace {
+    const size_t MAX_DESCRIBED_ELIMINATIONS = 3;
+
+    auto tag_name(DeductionTag tag) -> const char* {
+        switch (tag) {
+            // clang-format off
+            case DeductionTag::NakedSingles:       return "Naked single";
+            case DeductionTag::HiddenSingles:      return "Hidden single";
+            case DeductionTag::LockedCandidates:   return "Locked candidates";
+            case DeductionTag::Subsets:            return "Subset";
+            case DeductionTag::BasicFish:          return "Fish";
+            case DeductionTag::Fish:               return "Fish";
+            case DeductionTag::Wing:               return "Wing";
+            case DeductionTag::AvoidableRectangle: return "Avoidable rectangle";
+            // clang-format on
+            default:
+                return "Unknown";
+        }
+    }
+
+    // 1-based, like the digits
+    auto cell_name(int cell) -> std::string {
+        return "r" + std::to_string(row(cell) + 1) + "c" + std::to_string(col(cell) + 1);
+    }
+
+    // Native hints don't say which single they found,
+    // a cell with a single candidate left is a naked single either way.
+    auto native_step(const GridWidgetState& state, Hint hint) -> PathStep {
+        if (!hint.candidate.has_value()) {
+            return PathStep{
+                .tag = DeductionTag::LockedCandidates,
+                .effects = { .placement = {}, .eliminations = std::move(hint.conflicts) },
+            };
+        }
+        auto candidate = *hint.candidate;
+        auto is_naked = std::popcount(state[candidate.cell].candidate_mask()) == 1;
+        return PathStep{
+            .tag = is_naked ? DeductionTag::NakedSingles : DeductionTag::HiddenSingles,
+            .effects = { .placement = candidate, .eliminations = {} },
+        };
+    }
+}
+
+auto describe_step(const PathStep& step) -> std::string {
+    std::string text = tag_name(step.tag);
+    text += ": ";
+
+    const auto& effects = step.effects;
+    if (effects.placement.has_value()) {
+        auto placement = *effects.placement;
+        return text + cell_name(placement.cell) + " = " + std::to_string(placement.num);
+    }
+    if (effects.eliminations.empty()) {
+        return text + "nothing to do";
+    }
+
+    auto n_described = std::min(effects.eliminations.size(), MAX_DESCRIBED_ELIMINATIONS);
+    for (size_t i = 0; i < n_described; i++) {
+        auto elimination = effects.eliminations[i];
+        text += (i == 0 ? "" : ", ") + cell_name(elimination.cell) + " ≠ " + std::to_string(elimination.num);
+    }
+    if (effects.eliminations.size() > n_described) {
+        text += " and " + std::to_string(effects.eliminations.size() - n_described) + " more";
+    }
+    return text;
+}
+
+auto step_hint(const PathStep& step) -> Hint {
+    Hint hint;
+    hint.candidate = step.effects.placement;
+    hint.conflicts = step.effects.eliminations;
+
+    if (hint.candidate.has_value()) {
+        auto candidate = *hint.candidate;
+        hint.set_cell_highlight(candidate.cell, HintHighlight::Strong);
+        hint.set_digit_highlight(candidate.cell, candidate.num - 1, false);
+    }
+    for (auto conflict : hint.conflicts) {
+        hint.set_cell_highlight(conflict.cell, HintHighlight::Weak);
+        hint.set_digit_highlight(conflict.cell, conflict.num - 1, true);
+    }
+    return hint;
+}
+
+auto apply_step(GridWidgetState& state, const PathStep& step) -> void {
+    if (step.effects.placement.has_value()) {
+        auto placement = *step.effects.placement;
+        state[placement.cell] = CellWidgetState::entry(placement.num);
+        for (auto peer : PEERS[placement.cell]) {
+            state[peer] = state[peer].with_candidate(placement.num, false);
+        }
+    }
+    for (auto elimination : step.effects.eliminations) {
+        state[elimination.cell] = state[elimination.cell].with_candidate(elimination.num, false);
+    }
+}
+
+auto step_status(const GridWidgetState& state, const PathStep& step) -> StepStatus {
+    auto is_pending = false;
+
+    if (step.effects.placement.has_value()) {
+        auto placement = *step.effects.placement;
+        auto cell_state = state[placement.cell];
+        if (cell_state.digit() == placement.num) {
+            // done
+        } else if (!cell_state.is_candidates() || !cell_state.candidates()[placement.num - 1]) {
+            return StepStatus::Invalid;
+        } else {
+            is_pending = true;
+        }
+    }
+
+    for (auto elimination : step.effects.eliminations) {
+        auto cell_state = state[elimination.cell];
+        if (cell_state.digit() == elimination.num) {
+            return StepStatus::Invalid;
+        }
+        is_pending |= cell_state.is_candidates() && cell_state.candidates()[elimination.num - 1];
+    }
+    return is_pending ? StepStatus::Pending : StepStatus::Done;
+}
+
+auto is_filled(const GridWidgetState& state) -> bool {
+    return std::none_of(state.begin(), state.end(), [](CellWidgetState cell_state) {
+        return cell_state.is_candidates();
+    });
+}
+
+auto is_progress(const GridWidgetState& before, const GridWidgetState& after) -> bool {
+    for (int cell = 0; cell < 81; cell++) {
+        if (before[cell] == after[cell]) {
+            continue;
+        }
+        if (!before[cell].is_candidates()) {
+            return false;
+        }
+        auto added = after[cell].candidate_mask() & ~before[cell].candidate_mask();
+        if (after[cell].is_candidates() && added != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SolutionPathSearch::SolutionPathSearch(GridWidgetState start, std::vector<Strategy> strategies)
+    : m_start(start), m_strategies(std::move(strategies)) {}
+
+// Native strategies go one step at a time. Once they don't suffice, the strategy solver
+// runs the rest of the way in one call, there's no asking it for one deduction at a time
+// without starting over from scratch for every step.
+auto SolutionPathSearch::run() -> void {
+    auto state = m_start;
+
+    while (!m_cancelled) {
+        auto native = native_hint(to_grid_state(state), m_strategies);
+        if (!native.is_conclusive) {
+            break;
+        }
+        if (!native.hint.has_value()) {
+            this->finish();
+            return;
+        }
+        auto step = native_step(state, std::move(*native.hint));
+        apply_step(state, step);
+        this->publish(std::move(step));
+    }
+
+    auto deductions = SolverHandle(to_grid_state(state)).solve(m_strategies);
+    for (size_t i = 0; i < deductions.size() && !m_cancelled; i++) {
+        auto deduction = deductions[i];
+        auto step = PathStep{ .tag = deduction.tag, .effects = deduction_effects(deduction) };
+        apply_step(state, step);
+        this->publish(std::move(step));
+    }
+    this->finish();
+}
+
+auto SolutionPathSearch::publish(PathStep step) -> void {
+    std::lock_guard lock(m_mutex);
+    m_found.push_back(std::move(step));
+}
+
+auto SolutionPathSearch::finish() -> void {
+    std::lock_guard lock(m_mutex);
+    m_is_finished = true;
+}
+
+auto SolutionPathSearch::cancel() -> void {
+    m_cancelled = true;
+}
+
+auto SolutionPathSearch::take_steps(std::vector<PathStep>& steps) -> bool {
+    std::lock_guard lock(m_mutex);
+    steps.insert(steps.end(), std::make_move_iterator(m_found.begin()), std::make_move_iterator(m_found.end()));
+    m_found.clear();
+    return m_is_finished;
+}
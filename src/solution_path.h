@@ -0,0 +1,73 @@
+#pragma once
+// The deductions that lead from a grid to its solution, in order.
+// The path is worked out on a worker thread and handed over in pieces while it grows.
+// Steps only keep what they do to the grid, their hints are built when one is looked at,
+// so long paths stay small.
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "sudoku_ffi/sudoku.h"
+#include "cell_state.h"
+#include "hint.h"
+
+struct PathStep {
+    DeductionTag tag;
+    DeductionEffects effects;
+};
+
+// e.g. "Naked single: r4c7 = 5"
+auto describe_step(const PathStep& step) -> std::string;
+
+// Marks the digit to enter and the candidates to remove, not the pattern behind them.
+auto step_hint(const PathStep& step) -> Hint;
+
+// Carry out `step`. Placed digits are struck from the candidates of their peers, as the solver does.
+auto apply_step(GridWidgetState& state, const PathStep& step) -> void;
+
+enum class StepStatus {
+    // has something left to do in the grid
+    Pending,
+    // all of it is done already
+    Done,
+    // the grid disagrees with it, e.g. a different digit was entered
+    Invalid,
+};
+
+auto step_status(const GridWidgetState& state, const PathStep& step) -> StepStatus;
+
+// whether every cell has a digit
+auto is_filled(const GridWidgetState& state) -> bool;
+
+// Whether `after` only knows more than `before`: digits entered and candidates removed, nothing taken back.
+// Deductions that hold for `before` still hold for `after` then.
+auto is_progress(const GridWidgetState& before, const GridWidgetState& after) -> bool;
+
+// A path search, shared by the worker that runs it and the GUI thread that collects the steps.
+class SolutionPathSearch {
+    const GridWidgetState m_start;
+    const std::vector<Strategy> m_strategies;
+
+    mutable std::mutex m_mutex;
+    // found and not taken yet
+    std::vector<PathStep> m_found;
+    bool m_is_finished = false;
+
+    std::atomic<bool> m_cancelled = false;
+
+    auto publish(PathStep step) -> void;
+    auto finish() -> void;
+
+public:
+    SolutionPathSearch(GridWidgetState start, std::vector<Strategy> strategies);
+
+    // Find the path step by step, publishing each step as soon as it's known.
+    // Blocking, meant to be called on a worker thread. Stops early once cancelled.
+    auto run() -> void;
+    auto cancel() -> void;
+
+    // Move the steps found since the last call to the end of `steps`.
+    // Returns true once the search is finished and no more steps will follow.
+    auto take_steps(std::vector<PathStep>& steps) -> bool;
+};
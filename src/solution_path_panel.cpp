@@ -0,0 +1,192 @@
+#include "solution_path_panel.h"
+#include <QVBoxLayout>
+#include <QtConcurrentRun>
+#include <iterator>
+#include <utility>
+
+const int POLL_INTERVAL_MS = 50;
+
+auto SolutionPathModel::steps() const -> const std::vector<PathStep>& {
+    return m_steps;
+}
+
+auto SolutionPathModel::set_steps(std::vector<PathStep> steps) -> void {
+    this->beginResetModel();
+    m_steps = std::move(steps);
+    this->endResetModel();
+}
+
+auto SolutionPathModel::append_steps(std::vector<PathStep> steps) -> void {
+    if (steps.empty()) {
+        return;
+    }
+    auto first = static_cast<int>(m_steps.size());
+    this->beginInsertRows(QModelIndex(), first, first + static_cast<int>(steps.size()) - 1);
+    m_steps.insert(m_steps.end(), std::make_move_iterator(steps.begin()), std::make_move_iterator(steps.end()));
+    this->endInsertRows();
+}
+
+auto SolutionPathModel::rowCount(const QModelIndex& parent) const -> int {
+    return parent.isValid() ? 0 : static_cast<int>(m_steps.size());
+}
+
+auto SolutionPathModel::data(const QModelIndex& index, int role) const -> QVariant {
+    if (role != Qt::DisplayRole || !index.isValid()) {
+        return {};
+    }
+    auto description = describe_step(m_steps[index.row()]);
+    return QString("%1. %2").arg(index.row() + 1).arg(QString::fromStdString(description));
+}
+
+SolutionPathPanel::SolutionPathPanel(QWidget* parent)
+    : QWidget(parent), m_model(new SolutionPathModel(this)), m_list(new QListView(this)), m_status(new QLabel(this)) {
+    m_list->setModel(m_model);
+    m_list->setUniformItemSizes(true);
+    m_list->setFocusPolicy(Qt::ClickFocus);
+    // the hint of a step only exists while it's on the grid
+    connect(m_list, &QListView::activated, [this](const QModelIndex& index) {
+        emit step_activated(step_hint(m_model->steps()[index.row()]));
+    });
+
+    m_status->setWordWrap(true);
+
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_status);
+    layout->addWidget(m_list);
+
+    m_poll_timer.setInterval(POLL_INTERVAL_MS);
+    connect(&m_poll_timer, &QTimer::timeout, this, &SolutionPathPanel::poll);
+}
+
+SolutionPathPanel::~SolutionPathPanel() {
+    this->cancel_search();
+}
+
+auto SolutionPathPanel::set_strategies(std::vector<Strategy> strategies) -> void {
+    if (strategies == m_strategies) {
+        return;
+    }
+    m_strategies = std::move(strategies);
+    if (m_base.has_value()) {
+        this->restart();
+    }
+}
+
+// Steps that the edit completed are dropped, the path is cut off at the first one it contradicts
+// and the search picks up from there. A path that got stuck gets another try with what the edit added.
+auto SolutionPathPanel::grid_changed(const GridWidgetState& grid) -> void {
+    auto previous = std::exchange(m_grid, grid);
+    if (!m_base.has_value() || previous == grid) {
+        return;
+    }
+    if (!is_progress(*m_base, grid)) {
+        this->restart();
+        return;
+    }
+
+    const auto& steps = m_model->steps();
+    std::vector<PathStep> kept;
+    auto state = grid;
+    auto is_cut_off = false;
+    for (const auto& step : steps) {
+        auto status = step_status(state, step);
+        if (status == StepStatus::Invalid) {
+            is_cut_off = true;
+            break;
+        }
+        if (status == StepStatus::Pending) {
+            apply_step(state, step);
+            kept.push_back(step);
+        }
+    }
+    if (kept.size() != steps.size()) {
+        m_model->set_steps(std::move(kept));
+    }
+    m_base = grid;
+    m_end_state = state;
+
+    auto is_stuck = m_is_finished && !is_filled(m_end_state);
+    if (is_cut_off || is_stuck) {
+        this->start_search();
+    }
+    this->update_status();
+}
+
+auto SolutionPathPanel::restart() -> void {
+    m_model->set_steps({});
+    m_base = m_grid;
+    m_end_state = m_grid;
+    this->start_search();
+    this->update_status();
+}
+
+// continues from the end of the listed steps
+auto SolutionPathPanel::start_search() -> void {
+    this->cancel_search();
+    m_search = std::make_shared<SolutionPathSearch>(m_end_state, m_strategies);
+    m_is_finished = false;
+
+    auto search = m_search;
+    QtConcurrent::run([search]() { search->run(); });
+    m_poll_timer.start();
+}
+
+auto SolutionPathPanel::cancel_search() -> void {
+    if (m_search != nullptr) {
+        m_search->cancel();
+        m_search = nullptr;
+    }
+    m_poll_timer.stop();
+}
+
+// Found steps are checked against the grid as well, it may have been edited since the search started.
+auto SolutionPathPanel::poll() -> void {
+    std::vector<PathStep> found;
+    auto is_finished = m_search->take_steps(found);
+
+    std::vector<PathStep> kept;
+    for (auto& step : found) {
+        auto status = step_status(m_end_state, step);
+        if (status == StepStatus::Invalid) {
+            m_model->append_steps(std::move(kept));
+            this->start_search();
+            this->update_status();
+            return;
+        }
+        if (status == StepStatus::Pending) {
+            apply_step(m_end_state, step);
+            kept.push_back(std::move(step));
+        }
+    }
+    m_model->append_steps(std::move(kept));
+
+    if (is_finished) {
+        m_is_finished = true;
+        this->cancel_search();
+    }
+    this->update_status();
+}
+
+auto SolutionPathPanel::update_status() -> void {
+    auto n_steps = m_model->rowCount(QModelIndex());
+    if (!m_is_finished) {
+        m_status->setText(QString("Searching, %1 steps so far...").arg(n_steps));
+    } else if (is_filled(m_end_state)) {
+        m_status->setText(QString("%1 steps to the solution").arg(n_steps));
+    } else {
+        m_status->setText(QString("The selected strategies get stuck after %1 steps").arg(n_steps));
+    }
+}
+
+// nothing is searched for while hidden
+auto SolutionPathPanel::showEvent(QShowEvent* event) -> void {
+    this->restart();
+    QWidget::showEvent(event);
+}
+
+auto SolutionPathPanel::hideEvent(QHideEvent* event) -> void {
+    this->cancel_search();
+    m_base = {};
+    QWidget::hideEvent(event);
+}
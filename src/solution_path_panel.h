@@ -0,0 +1,75 @@
+#pragma once
+// Lists the deductions from the current grid to the solution while they're being found.
+// Edits that only add to what the grid knows keep the part of the path that still applies,
+// anything else, such as an undo, starts it over.
+
+#include <QAbstractListModel>
+#include <QHideEvent>
+#include <QLabel>
+#include <QListView>
+#include <QShowEvent>
+#include <QTimer>
+#include <QWidget>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "cell_state.h"
+#include "hint.h"
+#include "solution_path.h"
+
+class SolutionPathModel final : public QAbstractListModel {
+    Q_OBJECT
+
+    std::vector<PathStep> m_steps;
+
+public:
+    using QAbstractListModel::QAbstractListModel;
+
+    auto steps() const -> const std::vector<PathStep>&;
+    auto set_steps(std::vector<PathStep> steps) -> void;
+    auto append_steps(std::vector<PathStep> steps) -> void;
+
+    auto rowCount(const QModelIndex& parent) const -> int override;
+    // rows are described when the view asks for them
+    auto data(const QModelIndex& index, int role) const -> QVariant override;
+};
+
+class SolutionPathPanel final : public QWidget {
+    Q_OBJECT
+
+    SolutionPathModel* m_model;
+    QListView* m_list;
+    QLabel* m_status;
+    QTimer m_poll_timer;
+
+    std::vector<Strategy> m_strategies;
+    // the latest grid, even while hidden
+    GridWidgetState m_grid{};
+    // grid that the listed steps were checked against, nothing while hidden
+    std::optional<GridWidgetState> m_base;
+    // m_base with all listed steps applied, where the search continues
+    GridWidgetState m_end_state{};
+
+    std::shared_ptr<SolutionPathSearch> m_search;
+    bool m_is_finished = false;
+
+    auto restart() -> void;
+    auto start_search() -> void;
+    auto cancel_search() -> void;
+    auto poll() -> void;
+    auto update_status() -> void;
+
+public:
+    explicit SolutionPathPanel(QWidget* parent);
+    ~SolutionPathPanel();
+
+    auto set_strategies(std::vector<Strategy> strategies) -> void;
+    auto grid_changed(const GridWidgetState& grid) -> void;
+
+    auto showEvent(QShowEvent* event) -> void override;
+    auto hideEvent(QHideEvent* event) -> void override;
+
+signals:
+    // a step was picked to be shown on the grid
+    void step_activated(Hint hint);
+};
@@ -0,0 +1,45 @@
+#pragma once
+// The strategies offered by the GUI, ordered from easiest to hardest.
+// A puzzle's grade is the index of the hardest one it requires.
+
+#include <array>
+#include <cstdint>
+#include "sudoku_ffi/sudoku.h"
+
+constexpr std::array<Strategy, 12> STRATEGIES = {
+    Strategy::NakedSingles,
+    Strategy::HiddenSingles,
+    Strategy::LockedCandidates,
+    Strategy::NakedPairs,
+    Strategy::NakedTriples,
+    Strategy::NakedQuads,
+    Strategy::HiddenPairs,
+    Strategy::HiddenTriples,
+    Strategy::HiddenQuads,
+    Strategy::XWing,
+    Strategy::Swordfish,
+    Strategy::Jellyfish,
+};
+
+constexpr size_t N_GRADES = STRATEGIES.size();
+
+constexpr auto strategy_name(Strategy strategy) -> const char* {
+    switch (strategy) {
+        // clang-format off
+        case Strategy::NakedSingles:     return "Naked Singles";
+        case Strategy::HiddenSingles:    return "Hidden Singles";
+        case Strategy::LockedCandidates: return "Locked Candidates";
+        case Strategy::NakedPairs:       return "Naked Pairs";
+        case Strategy::NakedTriples:     return "Naked Triples";
+        case Strategy::NakedQuads:       return "Naked Quads";
+        case Strategy::HiddenPairs:      return "Hidden Pairs";
+        case Strategy::HiddenTriples:    return "Hidden Triples";
+        case Strategy::HiddenQuads:      return "Hidden Quads";
+        case Strategy::XWing:            return "X-Wing";
+        case Strategy::Swordfish:        return "Swordfish";
+        case Strategy::Jellyfish:        return "Jellyfish";
+        // clang-format on
+        default:
+            return "Unknown";
+    }
+}
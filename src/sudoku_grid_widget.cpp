@@ -1,18 +1,27 @@
 #include "sudoku_cell_widget.h"
 #include "sudoku_ffi/sudoku.h"
 #include "sudoku_grid_widget.h"
-#include "sudoku_helper.h"
+#include "what_if.h"
 #include <QDebug>
+#include <QDir>
 #include <QGridLayout>
+#include <QPainter>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QtConcurrentRun>
+#include <algorithm>
+#include <cstdint>
 #include <optional>
+#include <utility>
 
 const int MAJOR_LINE_SIZE = 6;
 const int MINOR_LINE_SIZE = 2;
+const size_t PUZZLES_PER_GRADE = 10;
+const size_t MAX_GENERATION_ATTEMPTS = 2000;
 
 
 SudokuGridWidget::SudokuGridWidget(QWidget* parent) : QuadraticQFrame(parent) {
-    this->initialize_cells();
-    this->generate_layout();
+    this->setFocusPolicy(Qt::FocusPolicy::ClickFocus);
 
     // set background to black
     // it will cause the appearance of black lines in combination
@@ -22,40 +31,139 @@ SudokuGridWidget::SudokuGridWidget(QWidget* parent) : QuadraticQFrame(parent) {
     this->setAutoFillBackground(true);
     this->setPalette(pal);
 
+    connect(&m_hint_watcher, &QFutureWatcherBase::finished, this, &SudokuGridWidget::hint_ready);
+    connect(&m_try_watcher, &QFutureWatcherBase::finished, this, &SudokuGridWidget::try_done);
+    connect(&m_generator_watcher, &QFutureWatcherBase::finished, this, &SudokuGridWidget::puzzle_generated);
+
+    // keep a stock of graded puzzles across runs so neither startup nor "new sudoku" waits for the generator
+    auto data_dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(data_dir);
+    auto pool_path = QDir(data_dir).filePath("puzzle_pool.txt").toStdString();
+    auto n_workers = std::max(1u, std::thread::hardware_concurrency() / 2);
+    m_puzzle_pool = std::make_unique<PuzzlePool>(PUZZLES_PER_GRADE, pool_path, n_workers);
+
     this->generate_new_sudoku();
 }
 
-auto SudokuGridWidget::cell_state(uint8_t cell) const -> const CellWidgetState& {
+// cancelled generations stop after their current attempt
+SudokuGridWidget::~SudokuGridWidget() {
+    *m_generation_cancelled = true;
+    m_generations.waitForFinished();
+}
+
+auto SudokuGridWidget::cell_state(uint8_t cell) const -> CellWidgetState {
     return this->sudoku_state()[cell];
 }
 
 auto SudokuGridWidget::reset() -> void {
-    m_stack_position = 0;
-    m_sudoku.resize(0);
-
-    m_in_hint_mode = false;
-    m_hint_candidate = {};
-    m_hint_conflicts = {};
+    m_shown_hint = {};
     m_highlighted_digit = 0;
+    m_hint_cache.clear();
+    this->cancel_pending_hint();
+    m_tried_candidate = {};
+    *m_generation_cancelled = true;
+    m_is_awaiting_puzzle = false;
+    this->setEnabled(true);
 }
 
+// If the pool ran dry, as on the first run, the grid stays empty and disabled
+// while a worker generates a puzzle of the selected grade or the farm files one.
 auto SudokuGridWidget::generate_new_sudoku() -> void {
+    auto pooled = m_puzzle_pool->take(m_difficulty);
+    if (pooled.has_value()) {
+        this->start_sudoku(*pooled);
+        return;
+    }
+
+    // cancels any generation that is still running
+    this->start_sudoku(Sudoku{});
+    m_is_awaiting_puzzle = true;
+    this->setEnabled(false);
+
+    auto running = m_generations.futures();
+    m_generations.clearFutures();
+    for (const auto& generation : running) {
+        if (!generation.isFinished()) {
+            m_generations.addFuture(generation);
+        }
+    }
+
+    m_generation_cancelled = std::make_shared<std::atomic<bool>>(false);
+    auto cancelled = m_generation_cancelled;
+    auto* pool = m_puzzle_pool.get();
+    auto grade = m_difficulty;
+    auto generation = QtConcurrent::run([=]() { return pool->generate(grade, MAX_GENERATION_ATTEMPTS, *cancelled); });
+    m_generations.addFuture(generation);
+    m_generator_watcher.setFuture(generation);
+}
+
+auto SudokuGridWidget::puzzle_generated() -> void {
+    auto sudoku = m_generator_watcher.result();
+    if (!m_is_awaiting_puzzle || !sudoku.has_value()) {
+        return; // another puzzle was started or a game loaded in the meantime
+    }
+    this->start_sudoku(*sudoku);
+}
+
+// Puzzles from collections aren't guaranteed to have a unique solution, mistakes aren't marked for those.
+auto SudokuGridWidget::start_sudoku(const Sudoku& sudoku) -> void {
     this->reset();
-    auto sudoku = sudoku_generate_unique();
-    auto& grid_state = m_sudoku.emplace_back();
+    m_solution = unique_solution(sudoku);
+    GridWidgetState grid_state;
 
     uint8_t cell = 0;
     for (auto& cell_state : grid_state) {
         auto digit = sudoku._0[cell];
         if (digit != 0) {
-            cell_state = Clue{ .digit = digit };
+            cell_state = CellWidgetState::clue(digit);
         } else {
-            cell_state = CellCandidates().set();
+            cell_state = CellWidgetState::from_candidates(0x1FF);
         }
         cell++;
     }
 
-    this->recompute_candidates();
+    m_candidate_engine.reset(grid_state);
+    m_candidate_engine.restrict_candidates(grid_state);
+    m_journal.reset(grid_state);
+    this->state_changed();
+    this->update_changed_cells();
+}
+
+auto SudokuGridWidget::saved_game() const -> SavedGame {
+    auto deltas = m_journal.deltas();
+    return SavedGame{
+        .initial = m_journal.initial_state(),
+        .deltas = std::vector<CellDelta>(deltas.begin(), deltas.end()),
+        .step_ends = m_journal.step_ends(),
+        .parents = m_journal.parents(),
+        .position = m_journal.node(),
+        .highlighted_digit = m_highlighted_digit,
+    };
+}
+
+// The solution is worked out again from the clues, it's not part of the save.
+auto SudokuGridWidget::load_game(const SavedGame& game) -> bool {
+    UndoJournal journal;
+    if (!journal.restore(game.initial, game.deltas, game.step_ends, game.parents, game.position)) {
+        return false;
+    }
+
+    this->reset();
+    m_journal = std::move(journal);
+    m_candidate_engine.reset(this->sudoku_state());
+    m_highlighted_digit = game.highlighted_digit;
+
+    Digits clues;
+    for (int cell = 0; cell < 81; cell++) {
+        auto initial = game.initial[cell];
+        clues[cell] = initial.is_clue() ? initial.digit() : 0;
+    }
+    auto count = count_solutions(clues, 2);
+    m_solution = count.n_solutions == 1 ? std::optional(count.solution) : std::nullopt;
+
+    this->state_changed();
+    this->update_changed_cells();
+    return true;
 }
 
 auto SudokuGridWidget::initialize_cells() -> void {
@@ -99,57 +207,259 @@ auto SudokuGridWidget::generate_layout() -> void {
     }
 }
 
-auto SudokuGridWidget::sudoku_state() -> GridWidgetState& {
-    return m_sudoku[m_stack_position];
+// Switch between painting the board in one widget and laying out a widget per cell.
+// The focused cell is lost on a switch.
+auto SudokuGridWidget::set_renderer(GridRenderer renderer) -> void {
+    if (renderer == m_renderer) {
+        return;
+    }
+    m_renderer = renderer;
+    m_focused_cell = {};
+
+    if (renderer == GridRenderer::CellWidgets) {
+        this->initialize_cells();
+        this->generate_layout();
+        this->setFocusPolicy(Qt::FocusPolicy::NoFocus);
+    } else {
+        // deletes the inner layouts, but not the widgets
+        delete this->layout();
+        for (auto*& cell : m_cells) {
+            delete cell;
+            cell = nullptr;
+        }
+        this->setFocusPolicy(Qt::FocusPolicy::ClickFocus);
+    }
+    this->update();
 }
 
-auto SudokuGridWidget::sudoku_state() const -> const GridWidgetState& {
-    return m_sudoku[m_stack_position];
+// Where the single widget renderer puts a cell.
+// Same geometry as the layout of the cell widgets.
+auto SudokuGridWidget::cell_rect(uint8_t cell) const -> QRect {
+    auto area = this->contentsRect();
+    auto lines_size = 2 * MAJOR_LINE_SIZE + 6 * MINOR_LINE_SIZE;
+    auto cell_size = std::max(0, (std::min(area.width(), area.height()) - lines_size) / 9);
+    auto grid_size = 9 * cell_size + lines_size;
+    auto origin = area.topLeft() + QPoint((area.width() - grid_size) / 2, (area.height() - grid_size) / 2);
+
+    // every third line between cells is a major one
+    auto offset = [&](int index) {
+        return index * cell_size + (index / 3) * MAJOR_LINE_SIZE + (index - index / 3) * MINOR_LINE_SIZE;
+    };
+    return QRect(origin + QPoint(offset(cell % 9), offset(cell / 9)), QSize(cell_size, cell_size));
 }
 
-auto SudokuGridWidget::grid_state() const -> GridState {
-    GridState grid_state{};
-    const auto& sudoku_state = this->sudoku_state();
-    for (int cell = 0; cell < 81; cell++) {
-        auto const cell_widget_state = sudoku_state[cell];
-        auto& cell_state = grid_state.grid[cell];
+// Nothing if `position` is on a line between cells or outside of the board.
+auto SudokuGridWidget::cell_at(QPoint position) const -> std::optional<uint8_t> {
+    for (uint8_t cell = 0; cell < 81; cell++) {
+        if (this->cell_rect(cell).contains(position)) {
+            return cell;
+        }
+    }
+    return {};
+}
 
-        if (std::holds_alternative<CellCandidates>(cell_widget_state)) {
-            auto candidates = std::get<CellCandidates>(cell_widget_state);
-            cell_state.tag = CellState::Tag::Candidates;
-            cell_state.candidates._0 = candidates.to_ulong();
-        } else {
-            uint8_t digit;
-            if (std::holds_alternative<Clue>(cell_widget_state)) {
-                digit = std::get<Clue>(cell_widget_state).digit;
-            } else {
-                digit = std::get<Entry>(cell_widget_state).digit;
-            }
-            cell_state.tag = CellState::Tag::Digit;
-            cell_state.digit._0 = digit;
+auto SudokuGridWidget::paintEvent(QPaintEvent* event) -> void {
+    // frame, the background is filled in automatically
+    QuadraticQFrame::paintEvent(event);
+    if (m_renderer != GridRenderer::SingleWidget) {
+        return;
+    }
+
+    QPainter painter;
+    painter.begin(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    auto has_focus = this->hasFocus();
+
+    for (uint8_t cell = 0; cell < 81; cell++) {
+        auto rect = this->cell_rect(cell);
+        if (!event->region().intersects(rect)) {
+            continue;
         }
+
+        auto start_ns = FrameProfiler::now();
+        auto appearance = this->cell_appearance(cell, has_focus && m_focused_cell == cell);
+        paint_cell(painter, rect, appearance, m_glyph_atlas, *m_profiler);
+        this->cell_painted(cell, appearance, start_ns);
+    }
+    painter.end();
+}
+
+auto SudokuGridWidget::keyPressEvent(QKeyEvent* event) -> void {
+    if (m_renderer == GridRenderer::SingleWidget && m_focused_cell.has_value()) {
+        this->key_pressed(*m_focused_cell, event);
+        return;
     }
-    return grid_state;
+    QuadraticQFrame::keyPressEvent(event);
 }
 
-auto SudokuGridWidget::recompute_candidates() -> void {
-    auto solver = this->strategy_solver();
+auto SudokuGridWidget::mousePressEvent(QMouseEvent* event) -> void {
+    if (m_renderer != GridRenderer::SingleWidget) {
+        QuadraticQFrame::mousePressEvent(event);
+        return;
+    }
 
-    auto& sudoku_state = this->sudoku_state();
-    for (int cell = 0; cell < 81; cell++) {
-        auto& cell_widget_state = sudoku_state[cell];
+    auto cell = this->cell_at(event->pos());
+    if (cell.has_value()) {
+        m_focused_cell = cell;
+        this->update_changed_cells();
+    }
+}
+
+// The focused cell is only highlighted while the grid has the keyboard focus.
+// QWidget's handlers would repaint the whole grid.
+auto SudokuGridWidget::focusInEvent(QFocusEvent*) -> void {
+    this->update_changed_cells();
+}
+
+auto SudokuGridWidget::focusOutEvent(QFocusEvent*) -> void {
+    this->update_changed_cells();
+}
+
+auto SudokuGridWidget::cell_has_focus(uint8_t cell) const -> bool {
+    if (m_renderer == GridRenderer::CellWidgets) {
+        return m_cells[cell]->hasFocus();
+    }
+    return this->hasFocus() && m_focused_cell == cell;
+}
 
-        // skip clues, the GridState does not distinguish between clue and entry
-        if (!std::holds_alternative<CellCandidates>(cell_widget_state)) {
+// Repaint the cells that look different from when they were last painted or scheduled for it.
+// Cheaper than repainting the whole grid, as most edits change less than a house and its peers.
+auto SudokuGridWidget::update_changed_cells() -> void {
+    for (uint8_t cell = 0; cell < 81; cell++) {
+        auto appearance = this->cell_appearance(cell, this->cell_has_focus(cell));
+        if (appearance == m_painted_appearances[cell]) {
             continue;
         }
+        m_painted_appearances[cell] = appearance;
 
-        auto& candidates = std::get<CellCandidates>(cell_widget_state);
-        auto solver_candidates = strategy_solver_cell_candidates(solver, cell);
-        candidates &= CellCandidates(solver_candidates);
+        if (m_renderer == GridRenderer::CellWidgets) {
+            m_cells[cell]->update();
+        } else {
+            this->update(this->cell_rect(cell));
+        }
     }
+}
 
-    this->update();
+auto SudokuGridWidget::cell_appearance(uint8_t cell, bool has_focus) const -> CellAppearance {
+    auto state = this->cell_state(cell);
+    auto highlighted_bit = m_highlighted_digit != 0 ? 1u << (m_highlighted_digit - 1) : 0u;
+
+    CellAppearance appearance{
+        .state = state,
+        .has_focus = has_focus,
+        .contains_highlighted_digit = (state.candidate_mask() & highlighted_bit) != 0,
+        .is_mistake = m_show_mistakes && this->is_mistake(cell),
+    };
+    if (m_shown_hint.has_value()) {
+        appearance.in_hint_mode = true;
+        appearance.hint_highlight = m_shown_hint->cell_highlights[cell];
+        appearance.digit_highlights = m_shown_hint->digit_highlights[cell];
+        appearance.conflict_highlights = m_shown_hint->conflict_highlights[cell];
+    }
+    return appearance;
+}
+
+// Keyboard input for `cell`, from its cell widget or, with the single widget renderer, the grid.
+auto SudokuGridWidget::key_pressed(uint8_t cell, QKeyEvent* event) -> void {
+    auto start_ns = FrameProfiler::now();
+
+    if (this->in_hint_mode()) {
+        return;
+    }
+
+    // move with arrow keys
+    Qt::Key arrow_keys[] = { Qt::Key_Left, Qt::Key_Up, Qt::Key_Right, Qt::Key_Down };
+    Direction directions[] = { Direction::Left, Direction::Up, Direction::Right, Direction::Down };
+
+    auto start = std::begin(arrow_keys);
+    auto end = std::end(arrow_keys);
+    auto position = std::find(start, end, event->key());
+
+    if (position != end) {
+        auto idx = std::distance(start, position);
+        this->input_received(start_ns);
+        this->move_focus(cell, directions[idx]);
+        return;
+    }
+
+    // entries and clues are unalterable except by undoing
+    auto cell_state = this->cell_state(cell);
+    if (!cell_state.is_candidates()) {
+        return;
+    }
+    auto candidates = cell_state.candidates();
+
+    // highest and lowest key to enter digits
+    auto one = Qt::Key_1;
+    auto nine = Qt::Key_9;
+
+    // keys for toggling pencilmarks
+    // clang-format off
+    std::array<Qt::Key, 9> second_row = {
+        Qt::Key_F1,
+        Qt::Key_F2,
+        Qt::Key_F3,
+        Qt::Key_F4,
+        Qt::Key_F5,
+        Qt::Key_F6,
+        Qt::Key_F7,
+        Qt::Key_F8,
+        Qt::Key_F9
+    };
+    // clang-format on
+
+    // <Space> and <Return> are dependent on the current highlighted digit
+    // <Space> toggles pencilmark, <Return> enters digit
+    auto highlighted_digit = m_highlighted_digit;
+    if (highlighted_digit != 0) {
+        auto candidate = Candidate{
+            .cell = cell,
+            .num = highlighted_digit,
+        };
+        if (event->key() == Qt::Key_Return) {
+            this->input_received(start_ns);
+            this->insert_candidate(candidate);
+        } else if (event->key() == Qt::Key_Space) {
+            bool is_possible = candidates[highlighted_digit - 1];
+            this->input_received(start_ns);
+            this->set_candidate(candidate, !is_possible);
+        } else if (event->key() == Qt::Key_T && candidates[highlighted_digit - 1]) {
+            this->input_received(start_ns);
+            this->try_candidate(candidate);
+        }
+    }
+
+    if (one <= event->key() && event->key() <= nine) {
+        uint8_t num = event->key() - Qt::Key_0;
+        this->input_received(start_ns);
+        this->insert_candidate(Candidate{
+            .cell = cell,
+            .num = num,
+        });
+    } else {
+        auto key_ptr = std::find(second_row.begin(), second_row.end(), event->key());
+
+        if (key_ptr != second_row.end()) {
+            int pos = std::distance(second_row.begin(), key_ptr);
+            bool is_possible = candidates[pos];
+            this->input_received(start_ns);
+            this->set_candidate(
+                Candidate{
+                    .cell = cell,
+                    .num = static_cast<uint8_t>(pos + 1),
+                },
+                !is_possible);
+        }
+    }
+}
+
+auto SudokuGridWidget::sudoku_state() const -> const GridWidgetState& {
+    return m_journal.state();
+}
+
+// kept up to date by the journal, no conversion needed
+auto SudokuGridWidget::grid_state() const -> const GridState& {
+    return m_journal.grid_state();
 }
 
 auto SudokuGridWidget::move_focus(int current_cell, Direction direction) -> void {
@@ -166,325 +476,377 @@ auto SudokuGridWidget::move_focus(int current_cell, Direction direction) -> void
     };
 
     auto n_cell = row * 9 + col;
-    m_cells[n_cell]->setFocus();
+    if (m_renderer == GridRenderer::CellWidgets) {
+        m_cells[n_cell]->setFocus();
+    } else {
+        m_focused_cell = n_cell;
+        this->update_changed_cells();
+    }
 }
 
-// Truncate the undo stack to the current position and push a copy of the current state
+// Close the current undo step.
+// Does nothing if no cell was changed since the last savepoint.
 auto SudokuGridWidget::push_savepoint() -> void {
-    // if the stack contains remnants from undo
-    // delete them
-    m_sudoku.resize(m_stack_position + 1);
-
-    auto state = this->sudoku_state();
-    m_sudoku.push_back(state);
-
-    m_stack_position++;
+    if (m_journal.commit()) {
+        this->state_changed();
+    }
 }
 
 auto SudokuGridWidget::undo() -> bool {
-    if (m_in_hint_mode) {
+    if (this->in_hint_mode()) {
         return false;
     }
 
-    if (m_stack_position > 0) {
-        m_stack_position--;
-        this->update();
-        return true;
+    auto undone = m_journal.undo([this](const CellDelta& delta) {
+        m_candidate_engine.update_cell(delta.cell, delta.old_state, delta.new_state);
+    });
+    if (undone) {
+        this->state_changed();
+        this->update_changed_cells();
     }
-    return false;
+    return undone;
 }
 
 auto SudokuGridWidget::redo() -> bool {
-    if (m_in_hint_mode) {
+    if (this->in_hint_mode()) {
         return false;
     }
-    if (m_stack_position + 1 < m_sudoku.size()) {
-        m_stack_position++;
-        this->update();
-        return true;
+
+    auto redone = m_journal.redo([this](const CellDelta& delta) {
+        m_candidate_engine.update_cell(delta.cell, delta.old_state, delta.new_state);
+    });
+    if (redone) {
+        this->state_changed();
+        this->update_changed_cells();
+    }
+    return redone;
+}
+
+// Move to the next or previous of the branches that split off where the current step was made.
+// The grid is rebuilt from the nearest checkpoint, so this costs the same however long the branches are.
+auto SudokuGridWidget::switch_branch(int direction) -> bool {
+    if (this->in_hint_mode()) {
+        return false;
+    }
+
+    auto sibling = m_journal.sibling(direction);
+    if (!sibling.has_value()) {
+        return false;
+    }
+    m_journal.go_to(*sibling, [this](const CellDelta& delta) {
+        m_candidate_engine.update_cell(delta.cell, delta.old_state, delta.new_state);
+    });
+    this->state_changed();
+    this->update_changed_cells();
+    return true;
+}
+
+// Enter `candidate` as a new branch of the undo tree and check in the background whether the singles
+// it leads to contradict each other. Undo goes back to where it was tried, switch_branch to the other lines.
+auto SudokuGridWidget::try_candidate(Candidate candidate) -> void {
+    if (this->in_hint_mode()) {
+        return;
+    }
+    auto cell_state = this->cell_state(candidate.cell);
+    if (!cell_state.is_candidates() || !cell_state.candidates()[candidate.num - 1]) {
+        return;
+    }
+
+    this->insert_candidate(candidate);
+
+    // a check that is still running is superseded, its watcher won't report it any more
+    m_tried_candidate = candidate;
+    auto state = this->sudoku_state();
+    m_try_watcher.setFuture(QtConcurrent::run([state]() { return singles_contradict(state); }));
+}
+
+auto SudokuGridWidget::try_done() -> void {
+    if (!m_tried_candidate.has_value()) {
+        return; // a new puzzle was started in the meantime
+    }
+    auto candidate = *std::exchange(m_tried_candidate, std::nullopt);
+    emit candidate_tried(candidate, m_try_watcher.result());
+}
+
+// Fill in the solution, replacing wrong entries. One undo step.
+// Puzzles without a unique solution are solved from their clues and entries, if possible.
+auto SudokuGridWidget::solve() -> void {
+    if (this->in_hint_mode()) {
+        return;
+    }
+
+    auto solution = m_solution;
+    if (!solution.has_value()) {
+        auto count = count_solutions(this->sudoku_state(), 1);
+        if (count.n_solutions == 0) {
+            return;
+        }
+        solution = count.solution;
     }
-    return false;
+
+    for (uint8_t cell = 0; cell < 81; cell++) {
+        auto old_state = this->sudoku_state()[cell];
+        if (old_state.is_clue() || old_state.digit() == (*solution)[cell]) {
+            continue;
+        }
+        auto new_state = CellWidgetState::entry((*solution)[cell]);
+        m_journal.set_cell(cell, new_state);
+        m_candidate_engine.update_cell(cell, old_state, new_state);
+    }
+    this->push_savepoint();
+    this->update_changed_cells();
 }
 
+// An entry that doesn't match the solution. Never true if the solution isn't known.
+auto SudokuGridWidget::is_mistake(uint8_t cell) const -> bool {
+    auto state = this->cell_state(cell);
+    return m_solution.has_value() && state.is_entry() && state.digit() != (*m_solution)[cell];
+}
+
+auto SudokuGridWidget::set_show_mistakes(bool show) -> void {
+    m_show_mistakes = show;
+    this->update_changed_cells();
+}
 
 auto SudokuGridWidget::insert_candidate(Candidate candidate) -> void {
+    ScopedProfile profile(*m_profiler, ProfileEvent::Edit);
+
+    this->_insert_candidate(candidate);
     this->push_savepoint();
+    this->update_changed_cells();
+}
 
-    auto& grid_state = this->sudoku_state();
-    auto& cell_state = grid_state[candidate.cell];
+// enter the digit and strike it from the peers, don't create a savepoint
+auto SudokuGridWidget::_insert_candidate(Candidate candidate) -> void {
     // cell is already filled, don't do anything
-    if (!std::holds_alternative<CellCandidates>(cell_state)) {
+    if (!this->sudoku_state()[candidate.cell].is_candidates()) {
         return;
     }
 
-    cell_state = Entry{ .digit = candidate.num };
-    this->recompute_candidates();
+    m_journal.set_cell(candidate.cell, CellWidgetState::entry(candidate.num));
+    m_candidate_engine.place(candidate.cell, candidate.num);
+    for (auto peer : CandidateEngine::peers(candidate.cell)) {
+        this->_set_candidate(Candidate{ .cell = peer, .num = candidate.num }, false);
+    }
 }
 
-// Store savepoint and set candidate
+// Set candidate and store savepoint
 auto SudokuGridWidget::set_candidate(Candidate candidate, bool is_possible) -> void {
-    this->push_savepoint();
+    ScopedProfile profile(*m_profiler, ProfileEvent::Edit);
     this->_set_candidate(candidate, is_possible);
-    this->update();
+    this->push_savepoint();
+    this->update_changed_cells();
 }
 
 // set candidate in storage and cell, don't create a savepoint
 auto SudokuGridWidget::_set_candidate(Candidate candidate, bool is_possible) -> void {
-    auto& cell_state = this->sudoku_state()[candidate.cell];
-    if (!std::holds_alternative<CellCandidates>(cell_state)) {
-        return;
-    }
-    auto& cell_cands = std::get<CellCandidates>(cell_state);
-    cell_cands &= ~(1u << (candidate.num - 1));
-    cell_cands |= (uint16_t) is_possible << (candidate.num - 1);
+    auto cell_state = this->sudoku_state()[candidate.cell];
+    m_journal.set_cell(candidate.cell, cell_state.with_candidate(candidate.num, is_possible));
 }
 
 auto SudokuGridWidget::highlight_digit(int digit) -> void {
     assert(digit >= 0 && digit < 10);
     m_highlighted_digit = digit;
-    this->update();
+    this->update_changed_cells();
 }
 
+// Pressed once, show a hint. It is usually precomputed already,
+// otherwise it's computed in the background and shown when it's ready.
+// Pressed again while the hint is shown, apply it.
 auto SudokuGridWidget::hint(std::vector<Strategy> strategies) -> void {
-    if (m_in_hint_mode) {
-        // insert the results of the hint
-        if (m_hint_candidate.has_value()) {
-            this->insert_candidate(*m_hint_candidate);
-            m_hint_candidate = {};
-        }
-        if (m_hint_conflicts.has_value()) {
-            this->push_savepoint();
-
-            auto len = conflicts_len(*m_hint_conflicts);
-            for (uint32_t i = 0; i < len; i++) {
-                auto conflict = conflicts_get(*m_hint_conflicts, i);
-                this->_set_candidate(conflict, false);
-            }
-            m_hint_conflicts = {};
-            this->recompute_candidates();
-        }
+    if (this->in_hint_mode()) {
+        this->apply_hint();
+        return;
+    }
+
+    this->request_hint(strategies, true);
+}
+
+// Start computing the hint for the current grid unless it's cached or already in progress.
+// If `show` is set, the hint is displayed as soon as it's available.
+auto SudokuGridWidget::request_hint(const std::vector<Strategy>& strategies, bool show) -> void {
+    auto key = HintKey{ .grid = this->sudoku_state(), .strategies = strategies };
 
-        // reset out of hint mode
-        m_in_hint_mode = false;
-        for (auto* cell : m_cells) {
-            cell->reset_hint_highlights();
-            cell->update();
+    if (const auto* cached = m_hint_cache.find(key)) {
+        if (show && cached->has_value()) {
+            this->show_hint(**cached);
         }
         return;
     }
 
-    auto solver = this->strategy_solver();
-    auto results = strategy_solver_solve(solver, strategies.data(), strategies.size());
-    auto deductions = results.deductions;
-    auto n_deductions = deductions_len(deductions);
+    if (m_pending_hint.has_value() && *m_pending_hint == key) {
+        m_show_pending_hint |= show;
+        return;
+    }
+
+    // supersedes any hint that is still being computed
+    auto generation = ++*m_hint_generation;
+    m_pending_hint = key;
+    m_show_pending_hint = show;
+
+    auto grid_state = this->grid_state();
+    auto current_generation = m_hint_generation;
+    auto profiler = m_profiler;
+    m_hint_watcher.setFuture(QtConcurrent::run([=]() -> std::optional<Hint> {
+        // don't bother if the request became obsolete while it was waiting for a thread
+        if (current_generation->load() != generation) {
+            return {};
+        }
+        ScopedProfile profile(*profiler, ProfileEvent::Hint);
+        return compute_hint(grid_state, strategies);
+    }));
+}
 
-    qDebug() << n_deductions;
-    if (n_deductions == 0) {
+// Drop the hint that is being computed, if any.
+auto SudokuGridWidget::cancel_pending_hint() -> void {
+    ++*m_hint_generation;
+    m_pending_hint = {};
+    m_show_pending_hint = false;
+}
+
+// called on the GUI thread when the hint computation finishes
+auto SudokuGridWidget::hint_ready() -> void {
+    if (!m_pending_hint.has_value()) {
+        return; // cancelled
+    }
+    auto key = std::move(*m_pending_hint);
+    auto show = m_show_pending_hint;
+    m_pending_hint = {};
+    m_show_pending_hint = false;
+
+    // the result is valid for its key even if the grid has moved on since
+    auto hint = m_hint_watcher.result();
+    m_hint_cache.insert(key, hint);
+
+    if (!show || this->in_hint_mode() || key.grid != this->sudoku_state()) {
+        return;
+    }
+    if (!hint.has_value()) {
         return; // nothing found, don't change anything
     }
+    this->show_hint(*hint);
+}
+
+// Grade of the puzzles served by `generate_new_sudoku`, see STRATEGIES.
+// Nothing for any grade.
+auto SudokuGridWidget::set_difficulty(std::optional<uint8_t> grade) -> void {
+    m_difficulty = grade;
+    if (m_is_awaiting_puzzle) {
+        this->generate_new_sudoku();
+    }
+}
 
-    // find and mark cell
-    // also give a lighter highlight to all cells in the same line or col
-    // to guide the eyes
-    auto deduction = deductions_get(deductions, 0);
+// Strategies to use for the hints that are precomputed after every move.
+auto SudokuGridWidget::set_strategies(std::vector<Strategy> strategies) -> void {
+    m_strategies = std::move(strategies);
+    this->precompute_hint();
+}
 
-    qDebug() << (int) deduction.tag << "\n";
+auto SudokuGridWidget::profiler() -> FrameProfiler& {
+    return *m_profiler;
+}
 
-    switch (deduction.tag) {
-        case DeductionTag::NakedSingles: {
-            auto candidate = deduction.data.naked_singles.candidate;
-            auto cell = candidate.cell;
-            auto row = cell / 9;
-            auto col = cell % 9;
-            this->set_house_highlight(row, HintHighlight::Weak);
-            this->set_house_highlight(col + 9, HintHighlight::Weak);
-            this->set_cell_highlight(cell, HintHighlight::Strong);
+auto SudokuGridWidget::glyph_atlas() -> GlyphAtlas& {
+    return m_glyph_atlas;
+}
 
-            m_hint_candidate = candidate;
-            break;
-        }
-        case DeductionTag::HiddenSingles: {
-            auto data = deduction.data.hidden_singles;
-            auto candidate = data.candidate;
-            auto house = house_of_cell(candidate.cell, data.house_type);
-            this->set_house_highlight(house, HintHighlight::Weak);
-            this->set_cell_highlight(candidate.cell, HintHighlight::Strong);
-
-            m_hint_candidate = candidate;
-            break;
-        }
-        case DeductionTag::LockedCandidates: {
-            auto data = deduction.data.locked_candidates;
-            auto digit = data.digit;
-            auto miniline = data.miniline;
-
-            auto block = block_of_miniline(miniline);
-            auto line = line_of_miniline(miniline);
-
-            this->set_house_highlight(block + 18, HintHighlight::Weak);
-            this->set_house_highlight(line, HintHighlight::Weak);
-
-            auto set_digit_highlights = [&](int cell) { m_cells[cell]->set_digit_highlight(digit - 1, false); };
-            if (data.is_pointing) {
-                foreach_cell_in_block(block, set_digit_highlights);
-            } else {
-                foreach_cell_in_house(line, set_digit_highlights);
-            }
-
-            m_hint_conflicts = data.conflicts;
-            break;
-        }
-        case DeductionTag::Subsets: {
-            auto data = deduction.data.subsets;
-            this->set_house_highlight(data.house, HintHighlight::Weak);
-            auto digits = std::bitset<9>(data.digits);
-            auto positions = std::bitset<9>(data.positions);
-            for (int pos = 0; pos < 9; pos++) {
-                if (!positions[pos]) {
-                    continue;
-                }
-                auto cell_nr = cell_at_position(data.house, pos);
-                this->set_cell_highlight(cell_nr, HintHighlight::Strong);
-
-                auto* cell = m_cells[cell_nr];
-                for (int digit = 0; digit < 9; digit++) {
-                    if (!digits[digit]) {
-                        continue;
-                    }
-                    cell->set_digit_highlight(digit, false);
-                }
-            }
-
-            m_hint_conflicts = data.conflicts;
-            break;
-        }
-        case DeductionTag::BasicFish: {
-            auto data = deduction.data.basic_fish;
-            auto lines = std::bitset<18>(data.lines);
-            auto positions = std::bitset<9>(data.positions);
-            auto digit = data.digit;
-
-            for (int line = 0; line < 18; line++) {
-                if (!lines[line]) {
-                    continue;
-                }
-                this->set_house_highlight(line, HintHighlight::Weak);
-                for (int pos = 0; pos < 9; pos++) {
-                    if (!positions[pos]) {
-                        continue;
-                    }
-                    auto cell_nr = cell_at_position(line, pos);
-                    this->set_cell_highlight(cell_nr, HintHighlight::Strong);
-                    auto* cell = m_cells[cell_nr];
-                    cell->set_digit_highlight(digit - 1, false);
-                }
-            }
-
-            m_hint_conflicts = data.conflicts;
-            break;
-        }
-        case DeductionTag::Wing: {
-            auto data = deduction.data.wing;
-            auto digits = std::bitset<9>(data.hinge_digits);
-            auto pincer_cells_lower = std::bitset<81>{ data.pincers[0] };
-            auto pincer_cells_upper = std::bitset<81>{ data.pincers[1] };
-            auto pincer_cells = pincer_cells_upper << 64 | pincer_cells_lower;
-            m_hint_conflicts = data.conflicts;
-
-            auto affected_cells = std::vector{ data.hinge };
-
-            for (size_t cell = 0; cell < 81; cell++) {
-                if (!pincer_cells[cell]) {
-                    continue;
-                }
-
-                affected_cells.push_back(cell);
-            }
-
-            for (auto pattern_cell : affected_cells) {
-                set_cell_highlight(pattern_cell, HintHighlight::Strong);
-                for (size_t digit = 0; digit < 9; digit++) {
-                    if (!digits[digit]) {
-                        continue;
-                    }
-                    m_cells[pattern_cell]->set_digit_highlight(digit, false);
-                }
-            }
-            break;
-        }
-        /*
-        case DeductionTag::Fish: {
-            auto data = deduction.data.fish;
-            break;
-        }
-        case DeductionTag::AvoidableRectangle: {
-            auto data = deduction.data.avoidable_rectangle;
-            break;
-        }
-        */
-        default:
-            break;
+// A key press that is going to repaint some cells.
+// Only the first one counts if several arrive before the next repaint.
+auto SudokuGridWidget::input_received(uint64_t start_ns) -> void {
+    if (!m_input_start_ns.has_value()) {
+        m_input_start_ns = start_ns;
     }
+}
+
+// Qt paints all cells that need it in one go, so the cell paints up to the
+// next pass of the event loop make up one frame.
+auto SudokuGridWidget::cell_painted(uint8_t cell, const CellAppearance& appearance, uint64_t start_ns) -> void {
+    auto end_ns = FrameProfiler::now();
+    m_painted_appearances[cell] = appearance;
+    m_profiler->record(ProfileEvent::CellPaint, start_ns, end_ns);
 
-    if (m_hint_candidate.has_value()) {
-        auto candidate = *m_hint_candidate;
-        m_cells[candidate.cell]->set_digit_highlight(candidate.num - 1, false);
+    if (!m_frame_start_ns.has_value()) {
+        m_frame_start_ns = start_ns;
+        QTimer::singleShot(0, this, [this]() { this->frame_done(); });
     }
+    m_frame_end_ns = end_ns;
+}
 
-    if (m_hint_conflicts.has_value()) {
-        auto len = conflicts_len(*m_hint_conflicts);
+auto SudokuGridWidget::frame_done() -> void {
+    m_profiler->record(ProfileEvent::Frame, *m_frame_start_ns, m_frame_end_ns);
+    if (m_input_start_ns.has_value()) {
+        m_profiler->record(ProfileEvent::KeyToPaint, *m_input_start_ns, m_frame_end_ns);
+    }
+    m_frame_start_ns = {};
+    m_input_start_ns = {};
+}
 
-        for (uint32_t i = 0; i < len; i++) {
-            auto conflict = conflicts_get(*m_hint_conflicts, i);
-            m_cells[conflict.cell]->set_digit_highlight(conflict.num - 1, true);
-        }
+auto SudokuGridWidget::show_hint(const Hint& hint) -> void {
+    m_shown_hint = hint;
+    this->update_changed_cells();
+}
+
+// insert the results of the hint and leave hint mode
+auto SudokuGridWidget::apply_hint() -> void {
+    auto hint = std::move(*m_shown_hint);
+    m_shown_hint = {};
+
+    this->_apply_effects(DeductionEffects{ .placement = hint.candidate, .eliminations = std::move(hint.conflicts) });
+    this->push_savepoint();
+    this->update_changed_cells();
+}
+
+// Apply the first `max_steps` deductions that `strategies` find one after the other, all of them if not given.
+// The solver runs once for all of them, they make a single undo step and the grid is repainted once.
+// Returns how many were applied.
+auto SudokuGridWidget::apply_deductions(const std::vector<Strategy>& strategies, std::optional<size_t> max_steps)
+    -> size_t {
+    if (this->in_hint_mode()) {
+        return 0;
     }
+    ScopedProfile profile(*m_profiler, ProfileEvent::Edit);
+
+    auto deductions = this->strategy_solver().solve(strategies);
+    auto n_steps = std::min(deductions.size(), max_steps.value_or(SIZE_MAX));
 
-    // update the cells or nothing happens
-    m_in_hint_mode = true;
-    for (auto* cell : m_cells) {
-        cell->update();
+    for (size_t i = 0; i < n_steps; i++) {
+        this->_apply_effects(deduction_effects(deductions[i]));
+    }
+    this->push_savepoint();
+    this->update_changed_cells();
+    return n_steps;
+}
+
+// apply a deduction, don't create a savepoint
+auto SudokuGridWidget::_apply_effects(const DeductionEffects& effects) -> void {
+    if (effects.placement.has_value()) {
+        this->_insert_candidate(*effects.placement);
+    }
+    for (auto elimination : effects.eliminations) {
+        this->_set_candidate(elimination, false);
     }
 }
 
 auto SudokuGridWidget::in_hint_mode() const -> bool {
-    return m_in_hint_mode;
+    return m_shown_hint.has_value();
 }
 
-auto SudokuGridWidget::strategy_solver() const -> StrategySolver {
-    return strategy_solver_from_grid_state(this->grid_state());
+// a new one for every solve, the bindings don't promise that solving leaves a solver as it was
+auto SudokuGridWidget::strategy_solver() const -> SolverHandle {
+    return SolverHandle(this->grid_state());
 }
 
-auto SudokuGridWidget::set_house_highlight(int house, HintHighlight highlight) -> void {
-    assert(house < 27);
-    if (house < 9) {
-        // row
-        auto limit = 9 * house + 9;
-        for (int cell = house * 9; cell < limit; cell++) {
-            set_cell_highlight(cell, highlight);
-        }
-    } else if (house < 18) {
-        // col
-        for (int cell = house - 9; cell < 81; cell += 9) {
-            set_cell_highlight(cell, highlight);
-        }
-    } else {
-        // block
-        auto block = house - 18;
-        auto band = block / 3;
-        auto stack = block % 3;
-        auto first_row = band * 3;
-        auto first_col = stack * 3;
-        for (int row = first_row; row < first_row + 3; row++) {
-            for (int col = first_col; col < first_col + 3; col++) {
-                auto cell = row * 9 + col;
-                set_cell_highlight(cell, highlight);
-            }
-        }
-    }
+// Invalidate everything derived from the previous grid state
+// and start working out the next hint before the player asks for it.
+auto SudokuGridWidget::state_changed() -> void {
+    emit state_edited(this->sudoku_state());
+    this->precompute_hint();
 }
 
-auto SudokuGridWidget::set_cell_highlight(int cell, HintHighlight highlight) -> void {
-    assert(cell < 81);
-    m_cells[cell]->m_hint_mode = highlight;
+auto SudokuGridWidget::precompute_hint() -> void {
+    if (m_strategies.empty()) {
+        this->cancel_pending_hint();
+        return;
+    }
+    this->request_hint(m_strategies, false);
 }
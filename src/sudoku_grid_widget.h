@@ -1,71 +1,185 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <optional>
 #include "sudoku_ffi/sudoku.h"
 #include <QFrame>
+#include <QFutureSynchronizer>
+#include <QFutureWatcher>
+#include <QFocusEvent>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPaintEvent>
 #include "quadratic_qframe.h"
 #include "hint_highlight.h"
 #include "cell_state.h"
+#include "candidate_engine.h"
+#include "undo_journal.h"
+#include "hint.h"
+#include "ffi_handles.h"
+#include "puzzle_pool.h"
+#include "brute_force.h"
+#include "game_file.h"
+#include "frame_profiler.h"
+#include "cell_painter.h"
 
 class SudokuCellWidget;
 
 enum class Direction { Left, Right, Up, Down };
 
-using GridWidgetState = std::array<CellWidgetState, 81>;
-using Candidates = std::array<uint16_t, 81>;
+// SingleWidget paints the whole board in the grid's paintEvent and does its own hit testing.
+// CellWidgets lays out one child widget per cell, which is how the grid used to work.
+enum class GridRenderer { SingleWidget, CellWidgets };
 
 class SudokuGridWidget final : public QuadraticQFrame {
     Q_OBJECT
 
+    GridRenderer m_renderer = GridRenderer::SingleWidget;
+    // only with GridRenderer::CellWidgets
     std::array<SudokuCellWidget*, 81> m_cells{};
-
-    uint32_t m_stack_position = 0;
-    std::vector<GridWidgetState> m_sudoku;
-
-    bool m_in_hint_mode = false;
-    std::optional<Candidate> m_hint_candidate;
-    std::optional<Conflicts> m_hint_conflicts;
+    // only with GridRenderer::SingleWidget, the cell widgets have their own focus
+    std::optional<uint8_t> m_focused_cell;
+    // what the cells looked like when they were last painted or scheduled for repainting
+    std::array<CellAppearance, 81> m_painted_appearances{};
+
+    std::unique_ptr<PuzzlePool> m_puzzle_pool;
+    std::optional<uint8_t> m_difficulty;
+    // whether the grid is an empty placeholder until m_generator_watcher delivers a puzzle
+    bool m_is_awaiting_puzzle = false;
+    // set to stop the generation that m_generator_watcher waits for
+    std::shared_ptr<std::atomic<bool>> m_generation_cancelled = std::make_shared<std::atomic<bool>>(false);
+    QFutureWatcher<std::optional<Sudoku>> m_generator_watcher;
+    // generations that may still be running, they use m_puzzle_pool
+    QFutureSynchronizer<std::optional<Sudoku>> m_generations;
+
+    UndoJournal m_journal;
+    CandidateEngine m_candidate_engine;
+
+    // of the current puzzle, found by brute force when it was started
+    std::optional<Digits> m_solution;
+    // paint entries that don't match the solution in red
+    bool m_show_mistakes = true;
+
+    // the hint that is on display, if any
+    std::optional<Hint> m_shown_hint;
+
+    // strategies for precomputed hints, as selected in the main window
+    std::vector<Strategy> m_strategies;
+    HintCache m_hint_cache;
+
+    // Bumped whenever a hint computation is started or cancelled.
+    // Queued computations compare against it to notice that they are stale.
+    std::shared_ptr<std::atomic<uint64_t>> m_hint_generation = std::make_shared<std::atomic<uint64_t>>(0);
+    // key of the hint that is being computed, if any
+    std::optional<HintKey> m_pending_hint;
+    // whether to show the pending hint once it's ready
+    bool m_show_pending_hint = false;
+    QFutureWatcher<std::optional<Hint>> m_hint_watcher;
+
+    // candidate whose singles check is running, if any
+    std::optional<Candidate> m_tried_candidate;
+    QFutureWatcher<bool> m_try_watcher;
+
+    // shared with hint computations, which may outlive the grid
+    std::shared_ptr<FrameProfiler> m_profiler = std::make_shared<FrameProfiler>();
+    GlyphAtlas m_glyph_atlas;
+    // first cell paint of the repaint in progress, if any, and end of the latest
+    std::optional<uint64_t> m_frame_start_ns;
+    uint64_t m_frame_end_ns = 0;
+    // key press that hasn't been painted yet
+    std::optional<uint64_t> m_input_start_ns;
 
 public:
     uint8_t m_highlighted_digit = 0; // 1-9, 0 for no highlight
 
 private:
-    auto strategy_solver() const -> StrategySolver;
-
-    auto sudoku_state() -> GridWidgetState&;
-    auto sudoku_state() const -> const GridWidgetState&;
+    auto strategy_solver() const -> SolverHandle;
 
-    auto grid_state() const -> GridState;
+    auto grid_state() const -> const GridState&;
     auto push_savepoint() -> void;
-    auto pop_savepoint() -> void;
     auto initialize_cells() -> void;
     auto generate_layout() -> void;
+
+    auto cell_rect(uint8_t cell) const -> QRect;
+    auto cell_at(QPoint position) const -> std::optional<uint8_t>;
+    auto cell_has_focus(uint8_t cell) const -> bool;
+    auto update_changed_cells() -> void;
     auto reset() -> void;
 
-    auto set_house_highlight(int, HintHighlight) -> void;
-    auto set_cell_highlight(int, HintHighlight) -> void;
+    auto state_changed() -> void;
+    auto precompute_hint() -> void;
+
+    auto apply_hint() -> void;
+    auto request_hint(const std::vector<Strategy>& strategies, bool show) -> void;
+    auto cancel_pending_hint() -> void;
+    auto hint_ready() -> void;
+    auto try_done() -> void;
+    auto puzzle_generated() -> void;
+
+    auto frame_done() -> void;
 
-    // auto _insert_candidate(Candidate candidate) -> void;
+    auto _insert_candidate(Candidate candidate) -> void;
     auto _set_candidate(Candidate candidate, bool is_possible) -> void;
+    auto _apply_effects(const DeductionEffects& effects) -> void;
 
 public:
     explicit SudokuGridWidget(QWidget* parent = 0);
+    ~SudokuGridWidget();
     auto generate_new_sudoku() -> void;
+    auto start_sudoku(const Sudoku& sudoku) -> void;
 
-    auto recompute_candidates() -> void;
+    auto saved_game() const -> SavedGame;
+    // Returns false and keeps the current game if the saved history is inconsistent.
+    auto load_game(const SavedGame& game) -> bool;
 
-    auto cell_state(uint8_t cell) const -> const CellWidgetState&;
+    auto cell_state(uint8_t cell) const -> CellWidgetState;
+    auto sudoku_state() const -> const GridWidgetState&;
+
+    auto set_renderer(GridRenderer renderer) -> void;
 
+    auto paintEvent(QPaintEvent* event) -> void override;
+    auto keyPressEvent(QKeyEvent* event) -> void override;
+    auto mousePressEvent(QMouseEvent* event) -> void override;
+    auto focusInEvent(QFocusEvent* event) -> void override;
+    auto focusOutEvent(QFocusEvent* event) -> void override;
+
+    auto cell_appearance(uint8_t cell, bool has_focus) const -> CellAppearance;
+    auto key_pressed(uint8_t cell, QKeyEvent* event) -> void;
     auto move_focus(int current_cell, Direction direction) -> void;
 
     auto insert_candidate(Candidate candidate) -> void;
     auto set_candidate(Candidate candidate, bool is_possible) -> void;
     auto undo() -> bool;
     auto redo() -> bool;
+    auto switch_branch(int direction) -> bool;
+    auto try_candidate(Candidate candidate) -> void;
+    auto solve() -> void;
+    auto apply_deductions(const std::vector<Strategy>& strategies, std::optional<size_t> max_steps = {}) -> size_t;
+
+    auto is_mistake(uint8_t cell) const -> bool;
+    auto set_show_mistakes(bool show) -> void;
 
     auto in_hint_mode() const -> bool;
+    // Pressing H applies the shown hint, as with hints the grid found itself.
+    auto show_hint(const Hint& hint) -> void;
+
+    auto set_strategies(std::vector<Strategy> strategies) -> void;
+    auto set_difficulty(std::optional<uint8_t> grade) -> void;
+
+    auto profiler() -> FrameProfiler&;
+    auto glyph_atlas() -> GlyphAtlas&;
+    // called by the cells
+    auto input_received(uint64_t start_ns) -> void;
+    auto cell_painted(uint8_t cell, const CellAppearance& appearance, uint64_t start_ns) -> void;
 
 public slots:
     void highlight_digit(int digit);
     void hint(std::vector<Strategy> strategies);
+
+signals:
+    // after every edit, undo and redo, and when a new puzzle is started
+    void state_edited(const GridWidgetState& state);
+    // when the singles check of `try_candidate` is done
+    void candidate_tried(Candidate candidate, bool is_contradiction);
 };
@@ -1,39 +1,41 @@
 #pragma once
 
 #include "sudoku_ffi/sudoku.h"
-#include <exception>
+#include "sudoku_tables.h"
+#include <stdexcept>
 #include <cassert>
 
 // ideally, the things in this file will either be expanded into
 // more powerful C++ solutions or added to the sudoku_ffi bindings
 // possibly a combination of both
+//
+// all lookups go through the tables in sudoku_tables.h
 
-auto row(int cell) -> int {
-    return cell / 9;
+inline auto row(int cell) -> int {
+    return HOUSES_OF_CELL[cell][0];
 }
 
-auto col(int cell) -> int {
-    return cell % 9;
+inline auto col(int cell) -> int {
+    return HOUSES_OF_CELL[cell][1] - 9;
 }
 
-
-auto band(int cell) -> int {
-    return cell / 27;
+inline auto block(int cell) -> int {
+    return HOUSES_OF_CELL[cell][2] - 18;
 }
 
-auto stack(int cell) -> int {
-    return col(cell) / 3;
+inline auto band(int cell) -> int {
+    return block(cell) / 3;
 }
 
-auto block_from_band_and_stack(int band, int stack) -> int {
-    return band * 3 + stack;
+inline auto stack(int cell) -> int {
+    return block(cell) % 3;
 }
 
-auto block(int cell) -> int {
-    return block_from_band_and_stack(band(cell), stack(cell));
+inline auto block_from_band_and_stack(int band, int stack) -> int {
+    return band * 3 + stack;
 }
 
-auto house_type(int house) -> HouseType {
+inline auto house_type(int house) -> HouseType {
     assert(house < 27);
     if (house < 9) {
         return HouseType::Row;
@@ -45,6 +47,8 @@ auto house_type(int house) -> HouseType {
 }
 
 // internal iteration because C++ iterators are crap
+// Stepping through the cells is cheaper than walking HOUSE_MASKS or CELLS_OF_HOUSE,
+// only the first cell of a block needs a lookup.
 template <typename F>
 auto foreach_cell_in_row(int row, F f) -> void {
     auto first_cell = row * 9;
@@ -55,19 +59,16 @@ auto foreach_cell_in_row(int row, F f) -> void {
 
 template <typename F>
 auto foreach_cell_in_col(int col, F f) -> void {
-    auto first_cell = col;
-    for (int cell = first_cell; cell < 81; cell += 9) {
+    for (int cell = col; cell < 81; cell += 9) {
         f(cell);
     }
 }
 
 template <typename F>
 auto foreach_cell_in_block(int block, F f) -> void {
-    auto first_row = block / 3 * 3;
-    auto first_col = block % 3 * 3;
-    for (int row = first_row; row < first_row + 3; row++) {
-        for (int col = first_col; col < first_col + 3; col++) {
-            auto cell = row * 9 + col;
+    auto first_cell = CELLS_OF_HOUSE[block + 18][0];
+    for (int row_start = first_cell; row_start < first_cell + 27; row_start += 9) {
+        for (int cell = row_start; cell < row_start + 3; cell++) {
             f(cell);
         }
     }
@@ -88,59 +89,41 @@ auto foreach_cell_in_house(int house, F f) -> void {
     }
 }
 
-auto house_of_cell(int cell, HouseType type) -> int {
+inline auto house_of_cell(int cell, HouseType type) -> int {
     switch (type) {
         case HouseType::Row:
-            return row(cell);
+            return HOUSES_OF_CELL[cell][0];
         case HouseType::Col:
-            return col(cell) + 9;
+            return HOUSES_OF_CELL[cell][1];
         case HouseType::Block:
-            return block(cell) + 18;
+            return HOUSES_OF_CELL[cell][2];
     }
     throw std::logic_error("got unexpected HouseType");
 }
 
-auto row_cell_at_position(int row, int position) -> int {
-    return row * 9 + position;
+inline auto cell_at_position(int house, int position) -> int {
+    assert(house < 27 && position < 9);
+    return CELLS_OF_HOUSE[house][position];
 }
 
-auto col_cell_at_position(int col, int position) -> int {
-    return 9 * position + col;
+inline auto row_cell_at_position(int row, int position) -> int {
+    return cell_at_position(row, position);
 }
 
-auto block_cell_at_position(int block, int position) -> int {
-    auto band = block / 3;
-    auto stack = block % 3;
-    auto row_in_block = position / 3;
-    auto col_in_block = position % 3;
-    auto row = 3 * band + row_in_block;
-    auto col = 3 * stack + col_in_block;
-    return 9 * row + col;
+inline auto col_cell_at_position(int col, int position) -> int {
+    return cell_at_position(col + 9, position);
 }
 
-auto cell_at_position(int house, int position) -> int {
-    switch (house_type(house)) {
-        case HouseType::Row:
-            return row_cell_at_position(house, position);
-        case HouseType::Col:
-            return col_cell_at_position(house - 9, position);
-        case HouseType::Block:
-            return block_cell_at_position(house - 18, position);
-    }
-    throw std::logic_error("got unexpected HouseType");
+inline auto block_cell_at_position(int block, int position) -> int {
+    return cell_at_position(block + 18, position);
 }
 
 // miniline functions
 
-auto block_of_miniline(int miniline) -> int {
-    if (miniline < 27) {
-        return block_from_band_and_stack(miniline / 9, miniline % 3);
-    } else {
-        return block_from_band_and_stack(miniline % 3, miniline / 9 - 3);
-    }
+inline auto block_of_miniline(int miniline) -> int {
+    return BLOCK_OF_MINILINE[miniline] - 18;
 }
 
-
-auto line_of_miniline(int miniline) -> int {
-    return miniline / 3;
+inline auto line_of_miniline(int miniline) -> int {
+    return LINE_OF_MINILINE[miniline];
 }
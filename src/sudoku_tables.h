@@ -0,0 +1,164 @@
+#pragma once
+// The geometry of the grid as lookup tables, generated at compile time.
+//
+// Houses are numbered 0-8 for rows, 9-17 for columns and 18-26 for blocks.
+// Minilines are the intersections of a line and a block, 3 cells each.
+// 0-26 are in rows, the row's three left to right, and 27-53 in columns, top to bottom.
+// So miniline / 3 is its line in house numbering.
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// A set of cells as an 81 bit mask, bit n for cell n.
+// Same layout as the pincers of a wing deduction.
+class CellSet {
+    uint64_t m_low = 0;  // cells 0-63
+    uint64_t m_high = 0; // cells 64-80
+
+public:
+    constexpr CellSet() = default;
+    constexpr CellSet(uint64_t low, uint64_t high) : m_low(low), m_high(high) {}
+
+    static constexpr auto single(int cell) -> CellSet {
+        return cell < 64 ? CellSet(uint64_t(1) << cell, 0) : CellSet(0, uint64_t(1) << (cell - 64));
+    }
+
+    constexpr auto low() const -> uint64_t {
+        return m_low;
+    }
+
+    constexpr auto high() const -> uint64_t {
+        return m_high;
+    }
+
+    constexpr auto contains(int cell) const -> bool {
+        return cell < 64 ? (m_low >> cell) & 1 : (m_high >> (cell - 64)) & 1;
+    }
+
+    constexpr auto is_empty() const -> bool {
+        return (m_low | m_high) == 0;
+    }
+
+    constexpr auto count() const -> int {
+        return std::popcount(m_low) + std::popcount(m_high);
+    }
+
+    constexpr auto operator|(CellSet other) const -> CellSet {
+        return CellSet(m_low | other.m_low, m_high | other.m_high);
+    }
+
+    constexpr auto operator&(CellSet other) const -> CellSet {
+        return CellSet(m_low & other.m_low, m_high & other.m_high);
+    }
+
+    constexpr auto without(CellSet other) const -> CellSet {
+        return CellSet(m_low & ~other.m_low, m_high & ~other.m_high);
+    }
+
+    constexpr auto operator==(const CellSet&) const -> bool = default;
+
+    // in ascending order
+    template <typename F>
+    constexpr auto foreach(F f) const -> void {
+        for (auto bits = m_low; bits != 0; bits &= bits - 1) {
+            f(std::countr_zero(bits));
+        }
+        for (auto bits = m_high; bits != 0; bits &= bits - 1) {
+            f(64 + std::countr_zero(bits));
+        }
+    }
+};
+
+// row, column and block of each cell, in house numbering
+constexpr auto HOUSES_OF_CELL = []() {
+    std::array<std::array<uint8_t, 3>, 81> houses{};
+    for (int cell = 0; cell < 81; cell++) {
+        auto row = cell / 9;
+        auto col = cell % 9;
+        auto block = row / 3 * 3 + col / 3;
+        houses[cell] = { static_cast<uint8_t>(row), static_cast<uint8_t>(col + 9), static_cast<uint8_t>(block + 18) };
+    }
+    return houses;
+}();
+
+// the cells of each house in ascending order, so position n is entry n
+constexpr auto CELLS_OF_HOUSE = []() {
+    std::array<std::array<uint8_t, 9>, 27> cells{};
+    std::array<int, 27> n_cells{};
+    for (int cell = 0; cell < 81; cell++) {
+        for (auto house : HOUSES_OF_CELL[cell]) {
+            cells[house][n_cells[house]++] = static_cast<uint8_t>(cell);
+        }
+    }
+    return cells;
+}();
+
+constexpr auto HOUSE_MASKS = []() {
+    std::array<CellSet, 27> masks{};
+    for (int house = 0; house < 27; house++) {
+        for (auto cell : CELLS_OF_HOUSE[house]) {
+            masks[house] = masks[house] | CellSet::single(cell);
+        }
+    }
+    return masks;
+}();
+
+// the 20 cells that share a house with each cell, in ascending order
+constexpr auto PEERS = []() {
+    std::array<std::array<uint8_t, 20>, 81> peers{};
+    for (int cell = 0; cell < 81; cell++) {
+        auto [row, col, block] = HOUSES_OF_CELL[cell];
+        auto mask = (HOUSE_MASKS[row] | HOUSE_MASKS[col] | HOUSE_MASKS[block]).without(CellSet::single(cell));
+        int n_peers = 0;
+        mask.foreach([&](int peer) { peers[cell][n_peers++] = static_cast<uint8_t>(peer); });
+    }
+    return peers;
+}();
+
+constexpr auto PEER_MASKS = []() {
+    std::array<CellSet, 81> masks{};
+    for (int cell = 0; cell < 81; cell++) {
+        for (auto peer : PEERS[cell]) {
+            masks[cell] = masks[cell] | CellSet::single(peer);
+        }
+    }
+    return masks;
+}();
+
+// line and block of each miniline, in house numbering
+constexpr auto LINE_OF_MINILINE = []() {
+    std::array<uint8_t, 54> lines{};
+    for (int miniline = 0; miniline < 54; miniline++) {
+        lines[miniline] = static_cast<uint8_t>(miniline / 3);
+    }
+    return lines;
+}();
+
+constexpr auto BLOCK_OF_MINILINE = []() {
+    std::array<uint8_t, 54> blocks{};
+    for (int miniline = 0; miniline < 54; miniline++) {
+        auto line = miniline / 3;
+        // the first cell of the miniline
+        auto cell = CELLS_OF_HOUSE[line][miniline % 3 * 3];
+        blocks[miniline] = HOUSES_OF_CELL[cell][2];
+    }
+    return blocks;
+}();
+
+constexpr auto CELLS_OF_MINILINE = []() {
+    std::array<std::array<uint8_t, 3>, 54> cells{};
+    for (int miniline = 0; miniline < 54; miniline++) {
+        auto line = LINE_OF_MINILINE[miniline];
+        for (int i = 0; i < 3; i++) {
+            cells[miniline][i] = CELLS_OF_HOUSE[line][miniline % 3 * 3 + i];
+        }
+    }
+    return cells;
+}();
+
+static_assert(PEERS[0][19] == 72);
+static_assert(CELLS_OF_HOUSE[9 + 4][8] == 76);
+static_assert(CELLS_OF_HOUSE[18 + 4] == std::array<uint8_t, 9>{ 30, 31, 32, 39, 40, 41, 48, 49, 50 });
+static_assert(BLOCK_OF_MINILINE[5] == 18 + 2 && BLOCK_OF_MINILINE[27 + 3 * 4 + 2] == 18 + 7);
+static_assert(HOUSE_MASKS[8].count() == 9 && PEER_MASKS[40].count() == 20);
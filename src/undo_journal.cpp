@@ -0,0 +1,215 @@
+#include "undo_journal.h"
+#include <cassert>
+
+auto UndoJournal::reset(const GridWidgetState& initial) -> void {
+    this->write_state(initial);
+    m_deltas.clear();
+    m_nodes.clear();
+    m_checkpoints.clear();
+    this->add_node(NO_NODE, 0);
+    this->add_checkpoint(0, initial);
+    m_node = 0;
+    m_open_step = {};
+}
+
+auto UndoJournal::state() const -> const GridWidgetState& {
+    return m_state;
+}
+
+auto UndoJournal::grid_state() const -> const GridState& {
+    return m_grid_state;
+}
+
+auto UndoJournal::write_state(const GridWidgetState& state) -> void {
+    m_state = state;
+    m_grid_state = to_grid_state(state);
+}
+
+auto UndoJournal::node() const -> uint32_t {
+    return m_node;
+}
+
+auto UndoJournal::n_nodes() const -> uint32_t {
+    return m_nodes.size();
+}
+
+auto UndoJournal::delta_begin(uint32_t node) const -> uint32_t {
+    return node == 0 ? 0 : m_nodes[node - 1].delta_end;
+}
+
+// the new node becomes its parent's first child and redo target
+auto UndoJournal::add_node(uint32_t parent, uint32_t delta_end) -> uint32_t {
+    auto node = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node{
+        .parent = parent,
+        .depth = parent == NO_NODE ? 0 : m_nodes[parent].depth + 1,
+        .delta_end = delta_end,
+        .first_child = NO_NODE,
+        .next_sibling = parent == NO_NODE ? NO_NODE : m_nodes[parent].first_child,
+        .redo_child = NO_NODE,
+    });
+    if (parent != NO_NODE) {
+        m_nodes[parent].first_child = node;
+        m_nodes[parent].redo_child = node;
+    }
+    return node;
+}
+
+auto UndoJournal::add_checkpoint(uint32_t node, const GridWidgetState& state) -> void {
+    m_checkpoints.insert_or_assign(node, state);
+}
+
+auto UndoJournal::mark_visited(uint32_t node) -> void {
+    while (node != 0) {
+        auto& parent = m_nodes[m_nodes[node].parent];
+        if (parent.redo_child == node) {
+            return;
+        }
+        parent.redo_child = node;
+        node = m_nodes[node].parent;
+    }
+}
+
+auto UndoJournal::set_cell(uint8_t cell, const CellWidgetState& new_state) -> void {
+    assert(cell < 81);
+    auto cell_state = m_state[cell];
+    if (cell_state == new_state) {
+        return;
+    }
+
+    if (!m_open_step.has_value()) {
+        m_open_step = m_deltas.size();
+    }
+
+    m_deltas.push_back(CellDelta{ .cell = cell, .old_state = cell_state, .new_state = new_state });
+    this->write_cell(cell, new_state);
+}
+
+auto UndoJournal::commit() -> bool {
+    if (!m_open_step.has_value()) {
+        return false;
+    }
+    m_open_step = {};
+
+    m_node = this->add_node(m_node, m_deltas.size());
+    if (m_nodes[m_node].depth % CHECKPOINT_INTERVAL == 0) {
+        this->add_checkpoint(m_node, m_state);
+    }
+    return true;
+}
+
+// siblings are listed newest first, the walk along their links allocates nothing
+auto UndoJournal::sibling(int direction) const -> std::optional<uint32_t> {
+    if (m_node == 0) {
+        return {};
+    }
+    auto first = m_nodes[m_nodes[m_node].parent].first_child;
+    auto next = m_nodes[m_node].next_sibling;
+    if (first == m_node && next == NO_NODE) {
+        return {};
+    }
+
+    if (direction > 0) {
+        return next != NO_NODE ? next : first;
+    }
+    // the sibling before the current node, the last one if the current node is the first
+    auto previous = first;
+    while (m_nodes[previous].next_sibling != m_node && m_nodes[previous].next_sibling != NO_NODE) {
+        previous = m_nodes[previous].next_sibling;
+    }
+    return previous;
+}
+
+// walks up to the checkpoint and replays the steps from there down
+auto UndoJournal::state_of(uint32_t node) const -> GridWidgetState {
+    assert(node < m_nodes.size());
+    std::array<uint32_t, CHECKPOINT_INTERVAL> path;
+    uint32_t path_length = 0;
+    while (m_nodes[node].depth % CHECKPOINT_INTERVAL != 0) {
+        path[path_length++] = node;
+        node = m_nodes[node].parent;
+    }
+
+    auto state = m_checkpoints.at(node);
+    for (auto i = path_length; i > 0; i--) {
+        auto step = path[i - 1];
+        for (auto delta = this->delta_begin(step); delta < m_nodes[step].delta_end; delta++) {
+            state[m_deltas[delta].cell] = m_deltas[delta].new_state;
+        }
+    }
+    return state;
+}
+
+auto UndoJournal::initial_state() const -> const GridWidgetState& {
+    return m_checkpoints.at(0);
+}
+
+auto UndoJournal::deltas() const -> std::span<const CellDelta> {
+    return std::span(m_deltas).subspan(0, m_nodes.back().delta_end);
+}
+
+auto UndoJournal::step_ends() const -> std::vector<uint32_t> {
+    std::vector<uint32_t> ends;
+    ends.reserve(m_nodes.size() - 1);
+    for (size_t node = 1; node < m_nodes.size(); node++) {
+        ends.push_back(m_nodes[node].delta_end);
+    }
+    return ends;
+}
+
+auto UndoJournal::parents() const -> std::vector<uint32_t> {
+    std::vector<uint32_t> parents;
+    parents.reserve(m_nodes.size() - 1);
+    for (size_t node = 1; node < m_nodes.size(); node++) {
+        parents.push_back(m_nodes[node].parent);
+    }
+    return parents;
+}
+
+// replays every step once from its parent's state to check it
+auto UndoJournal::restore(
+    const GridWidgetState& initial,
+    std::vector<CellDelta> deltas,
+    const std::vector<uint32_t>& step_ends,
+    const std::vector<uint32_t>& parents,
+    uint32_t node) -> bool {
+    auto n_steps = static_cast<uint32_t>(step_ends.size());
+    auto n_deltas = step_ends.empty() ? 0 : step_ends.back();
+    if (node > n_steps || n_deltas != deltas.size() || (!parents.empty() && parents.size() != n_steps)) {
+        return false;
+    }
+
+    std::vector<GridWidgetState> states{ initial };
+    states.reserve(n_steps + 1);
+    uint32_t begin = 0;
+    for (uint32_t step = 0; step < n_steps; step++) {
+        auto parent = parents.empty() ? step : parents[step];
+        auto end = step_ends[step];
+        if (parent > step || end <= begin) {
+            return false;
+        }
+        auto state = states[parent];
+        for (auto i = begin; i < end; i++) {
+            const auto& delta = deltas[i];
+            if (delta.cell >= 81 || state[delta.cell] != delta.old_state) {
+                return false;
+            }
+            state[delta.cell] = delta.new_state;
+        }
+        states.push_back(state);
+        begin = end;
+    }
+
+    this->reset(initial);
+    m_deltas = std::move(deltas);
+    for (uint32_t step = 0; step < n_steps; step++) {
+        auto child = this->add_node(parents.empty() ? step : parents[step], step_ends[step]);
+        if (m_nodes[child].depth % CHECKPOINT_INTERVAL == 0) {
+            this->add_checkpoint(child, states[child]);
+        }
+    }
+    m_node = node;
+    this->write_state(states[node]);
+    this->mark_visited(node);
+    return true;
+}
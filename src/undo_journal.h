@@ -0,0 +1,178 @@
+#pragma once
+// Undo/redo history of a sudoku grid stored as cell-level deltas.
+// The history is a tree: editing after an undo starts a new branch instead of discarding the undone steps.
+// Every step is a node with a contiguous run of deltas, nodes and their deltas are kept in the order
+// they were committed. A copy of the grid is only kept for nodes whose depth is a multiple of
+// CHECKPOINT_INTERVAL, so any node can be reconstructed from at most that many steps, no matter how
+// far away in the tree it is.
+// The current state is kept in the FFI representation as well, updated cell by cell along with it,
+// so the strategy solver can be handed the grid without converting all of it.
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include "cell_state.h"
+
+struct CellDelta {
+    uint8_t cell;
+    CellWidgetState old_state;
+    CellWidgetState new_state;
+};
+
+class UndoJournal {
+    static constexpr uint32_t CHECKPOINT_INTERVAL = 64;
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    // Node 0 is the initial state without any deltas.
+    // The deltas of node n are m_deltas[m_nodes[n - 1].delta_end, m_nodes[n].delta_end).
+    struct Node {
+        uint32_t parent;
+        uint32_t depth;
+        uint32_t delta_end;
+        uint32_t first_child;
+        uint32_t next_sibling;
+        // where redo goes, the child that was visited last
+        uint32_t redo_child;
+    };
+
+    GridWidgetState m_state{};
+    // m_state for the FFI
+    GridState m_grid_state{};
+
+    std::vector<CellDelta> m_deltas;
+    std::vector<Node> m_nodes;
+    // by node, for the nodes at depths that are multiples of CHECKPOINT_INTERVAL
+    std::unordered_map<uint32_t, GridWidgetState> m_checkpoints;
+
+    // node whose state m_state is
+    uint32_t m_node = 0;
+    // index into m_deltas where the step under construction begins
+    // or nothing if no edit has happened since the last commit
+    std::optional<uint32_t> m_open_step;
+
+    auto write_cell(uint8_t cell, CellWidgetState cell_state) -> void;
+    auto write_state(const GridWidgetState& state) -> void;
+    auto delta_begin(uint32_t node) const -> uint32_t;
+    auto add_node(uint32_t parent, uint32_t delta_end) -> uint32_t;
+    auto add_checkpoint(uint32_t node, const GridWidgetState& state) -> void;
+    // point the redo children from the root down to `node`
+    auto mark_visited(uint32_t node) -> void;
+
+public:
+    // Forget all history and start over from `initial`.
+    auto reset(const GridWidgetState& initial) -> void;
+
+    auto state() const -> const GridWidgetState&;
+    auto grid_state() const -> const GridState&;
+    // the current node, 0 before the first step
+    auto node() const -> uint32_t;
+    auto n_nodes() const -> uint32_t;
+
+    // Change a cell as part of the currently open step.
+    // Edits that don't change anything are not recorded.
+    auto set_cell(uint8_t cell, const CellWidgetState& new_state) -> void;
+
+    // Close the current step as a new child of the current node. Returns false if it didn't contain
+    // any change, in which case no step is added. Steps that were undone are kept as a separate branch.
+    auto commit() -> bool;
+
+    // Revert the last step. `on_delta` is called with each reverted delta,
+    // already reversed so that `old_state` is what the cell held before.
+    template <typename F>
+    auto undo(F on_delta) -> bool;
+
+    // Reapply the step that was undone last from the current node. `on_delta` is called with each reapplied delta.
+    template <typename F>
+    auto redo(F on_delta) -> bool;
+
+    // The sibling of the current node in `direction` (+1 or -1), wrapping around.
+    // Nothing if the current node has no siblings.
+    auto sibling(int direction) const -> std::optional<uint32_t>;
+
+    // Jump to any node. `on_delta` is called once for each cell that differs between the two states.
+    // Costs a checkpoint copy and less than CHECKPOINT_INTERVAL steps, however far apart the nodes are.
+    template <typename F>
+    auto go_to(uint32_t node, F on_delta) -> bool;
+
+    // Reconstruct the state of `node` from its nearest checkpoint.
+    auto state_of(uint32_t node) const -> GridWidgetState;
+
+    // The recorded history, for saving. Includes all branches.
+    auto initial_state() const -> const GridWidgetState&;
+    auto deltas() const -> std::span<const CellDelta>;
+    // of the nodes after the initial one, in commit order
+    auto step_ends() const -> std::vector<uint32_t>;
+    auto parents() const -> std::vector<uint32_t>;
+
+    // Replace the history with a saved one and move to `node`.
+    // The step after node n is node n + 1. Without `parents`, each step follows the one before.
+    // Returns false and leaves the journal as it was if the history doesn't add up:
+    // empty steps, parents that come after their children, deltas that don't start from the state they change
+    // or a node past the end.
+    auto restore(
+        const GridWidgetState& initial,
+        std::vector<CellDelta> deltas,
+        const std::vector<uint32_t>& step_ends,
+        const std::vector<uint32_t>& parents,
+        uint32_t node) -> bool;
+};
+
+inline auto UndoJournal::write_cell(uint8_t cell, CellWidgetState cell_state) -> void {
+    m_state[cell] = cell_state;
+    m_grid_state.grid[cell] = to_cell_state(cell_state);
+}
+
+template <typename F>
+auto UndoJournal::undo(F on_delta) -> bool {
+    if (m_open_step.has_value() || m_node == 0) {
+        return false;
+    }
+
+    auto begin = this->delta_begin(m_node);
+    auto end = m_nodes[m_node].delta_end;
+    for (auto i = end; i > begin; i--) {
+        const auto& delta = m_deltas[i - 1];
+        this->write_cell(delta.cell, delta.old_state);
+        on_delta(CellDelta{ .cell = delta.cell, .old_state = delta.new_state, .new_state = delta.old_state });
+    }
+    m_node = m_nodes[m_node].parent;
+    return true;
+}
+
+template <typename F>
+auto UndoJournal::redo(F on_delta) -> bool {
+    auto child = m_nodes[m_node].redo_child;
+    if (m_open_step.has_value() || child == NO_NODE) {
+        return false;
+    }
+
+    auto begin = this->delta_begin(child);
+    auto end = m_nodes[child].delta_end;
+    for (auto i = begin; i < end; i++) {
+        const auto& delta = m_deltas[i];
+        this->write_cell(delta.cell, delta.new_state);
+        on_delta(delta);
+    }
+    m_node = child;
+    return true;
+}
+
+template <typename F>
+auto UndoJournal::go_to(uint32_t node, F on_delta) -> bool {
+    if (m_open_step.has_value() || node >= m_nodes.size()) {
+        return false;
+    }
+
+    auto state = this->state_of(node);
+    for (uint8_t cell = 0; cell < 81; cell++) {
+        if (state[cell] != m_state[cell]) {
+            on_delta(CellDelta{ .cell = cell, .old_state = m_state[cell], .new_state = state[cell] });
+            this->write_cell(cell, state[cell]);
+        }
+    }
+    m_node = node;
+    this->mark_visited(node);
+    return true;
+}
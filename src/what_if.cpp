@@ -0,0 +1,46 @@
+#include "what_if.h"
+#include <array>
+#include "ffi_handles.h"
+#include "solution_path.h"
+#include "sudoku_tables.h"
+
+auto has_contradiction(const GridWidgetState& state) -> bool {
+    for (const auto& house : CELLS_OF_HOUSE) {
+        uint16_t placed = 0;
+        uint16_t possible = 0;
+        for (auto cell : house) {
+            auto cell_state = state[cell];
+            if (cell_state.is_candidates()) {
+                if (cell_state.candidate_mask() == 0) {
+                    return true;
+                }
+                possible |= cell_state.candidate_mask();
+                continue;
+            }
+            auto digit_bit = static_cast<uint16_t>(1 << (cell_state.digit() - 1));
+            if ((placed & digit_bit) != 0) {
+                return true;
+            }
+            placed |= digit_bit;
+        }
+        if ((placed | possible) != 0x1FF) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The solver isn't asked about grids that are broken already, what it deduces from them is meaningless.
+auto singles_contradict(GridWidgetState state) -> bool {
+    if (has_contradiction(state)) {
+        return true;
+    }
+
+    const std::array strategies = { Strategy::NakedSingles, Strategy::HiddenSingles };
+    auto deductions = SolverHandle(to_grid_state(state)).solve(strategies);
+    for (size_t i = 0; i < deductions.size(); i++) {
+        auto deduction = deductions[i];
+        apply_step(state, PathStep{ .tag = deduction.tag, .effects = deduction_effects(deduction) });
+    }
+    return has_contradiction(state);
+}
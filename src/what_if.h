@@ -0,0 +1,11 @@
+#pragma once
+// Checks whether a grid falls apart once the singles are filled in, to try out a candidate.
+
+#include "cell_state.h"
+
+// A cell without candidates, a house with a digit twice or a digit without a place in a house.
+auto has_contradiction(const GridWidgetState& state) -> bool;
+
+// Fill in naked and hidden singles with the strategy solver for as long as there are any
+// and check the result for contradictions. Blocking, meant to be called on a worker thread.
+auto singles_contradict(GridWidgetState state) -> bool;
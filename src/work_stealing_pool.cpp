@@ -0,0 +1,110 @@
+#include "work_stealing_pool.h"
+#include <algorithm>
+
+namespace {
+    // the pool and queue index of the current thread, if it is a worker
+    thread_local const WorkStealingPool* current_pool = nullptr;
+    thread_local size_t current_queue = 0;
+}
+
+WorkStealingPool::WorkStealingPool(unsigned n_threads) {
+    n_threads = std::max(n_threads, 1u);
+    for (unsigned i = 0; i < n_threads; i++) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < n_threads; i++) {
+        m_threads.emplace_back([this, i]() { this->run(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_available.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+auto WorkStealingPool::submit(std::function<void()> task) -> void {
+    auto index = current_pool == this ? current_queue : m_next_queue++ % m_queues.size();
+    {
+        auto& queue = *m_queues[index];
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        m_unclaimed++;
+        m_unfinished++;
+    }
+    m_work_available.notify_one();
+}
+
+auto WorkStealingPool::wait_idle() -> void {
+    std::unique_lock lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_unfinished == 0; });
+}
+
+auto WorkStealingPool::n_threads() const -> size_t {
+    return m_threads.size();
+}
+
+// Take a task that was already claimed, so one is guaranteed to exist in some queue.
+// Own queue first, newest task first, then the oldest task of the other queues.
+auto WorkStealingPool::take(size_t index) -> std::function<void()> {
+    while (true) {
+        {
+            auto& own = *m_queues[index];
+            std::lock_guard lock(own.mutex);
+            if (!own.tasks.empty()) {
+                auto task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return task;
+            }
+        }
+        for (size_t offset = 1; offset < m_queues.size(); offset++) {
+            auto& victim = *m_queues[(index + offset) % m_queues.size()];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                auto task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return task;
+            }
+        }
+        // the task was pushed but another worker got it first and left ours in a queue
+        // we already passed, go around again
+        std::this_thread::yield();
+    }
+}
+
+auto WorkStealingPool::run(size_t index) -> void {
+    current_pool = this;
+    current_queue = index;
+
+    while (true) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_work_available.wait(lock, [this]() { return m_stop || m_unclaimed > 0; });
+            if (m_stop) {
+                return;
+            }
+            m_unclaimed--;
+        }
+
+        auto task = this->take(index);
+        task();
+
+        bool idle;
+        {
+            std::lock_guard lock(m_mutex);
+            m_unfinished--;
+            idle = m_unfinished == 0;
+        }
+        if (idle) {
+            m_idle.notify_all();
+        }
+    }
+}
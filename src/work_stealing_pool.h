@@ -0,0 +1,56 @@
+#pragma once
+// A fixed set of worker threads, each with its own task queue.
+// Workers take tasks from the back of their own queue and steal from
+// the front of the others' when they run dry.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    // guards the counters below and is used for sleeping
+    std::mutex m_mutex;
+    std::condition_variable m_work_available;
+    std::condition_variable m_idle;
+    // tasks in the queues that no worker has claimed yet
+    size_t m_unclaimed = 0;
+    // tasks queued or running
+    size_t m_unfinished = 0;
+    bool m_stop = false;
+
+    // queue for submissions from outside of the pool
+    std::atomic<size_t> m_next_queue = 0;
+
+    auto run(size_t index) -> void;
+    auto take(size_t index) -> std::function<void()>;
+
+public:
+    explicit WorkStealingPool(unsigned n_threads);
+    // Stops the workers once their current task is done. Queued tasks are dropped.
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    auto operator=(const WorkStealingPool&) -> WorkStealingPool& = delete;
+
+    // Tasks submitted from a worker go to its own queue, others are spread round-robin.
+    auto submit(std::function<void()> task) -> void;
+
+    // Block until all submitted tasks have finished.
+    auto wait_idle() -> void;
+
+    auto n_threads() const -> size_t;
+};
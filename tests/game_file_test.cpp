@@ -0,0 +1,85 @@
+// Saved games with cell states that can't exist are rejected instead of loaded,
+// and a damaged archive stops a store instead of being copied.
+
+#include "game_file.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    int n_failures = 0;
+
+    auto check(bool condition, const char* what) -> void {
+        if (!condition) {
+            std::fprintf(stderr, "FAILED: %s\n", what);
+            n_failures++;
+        }
+    }
+
+    auto sample_game() -> SavedGame {
+        SavedGame game;
+        for (auto& cell_state : game.initial) {
+            cell_state = CellWidgetState::from_candidates(0x1FF);
+        }
+        game.initial[0] = CellWidgetState::clue(5);
+        game.deltas.push_back(CellDelta{
+            .cell = 1,
+            .old_state = game.initial[1],
+            .new_state = CellWidgetState::entry(3),
+        });
+        game.step_ends.push_back(1);
+        game.parents.push_back(0);
+        game.position = 1;
+        return game;
+    }
+
+    // offsets into an encoded record
+    constexpr size_t INITIAL_OFFSET = 8;
+    constexpr size_t FIRST_DELTA_OFFSET = INITIAL_OFFSET + 81 * 2 + 12 + 8;
+
+    auto with_bits(std::string record, size_t offset, uint16_t bits) -> std::string {
+        record[offset] = static_cast<char>(bits & 0xFF);
+        record[offset + 1] = static_cast<char>(bits >> 8);
+        return record;
+    }
+}
+
+auto main() -> int {
+    auto record = encode_game(sample_game());
+    check(decode_game(record).has_value(), "a valid game decodes");
+
+    // digit 10, digit 15, a clue flag without a digit, a reserved bit, candidates next to a digit
+    const uint16_t bad_states[] = { 10 << 9, 15 << 9, 1 << 13, 1 << 14, 1 << 15, 5 << 9 | 1 };
+    for (auto bits : bad_states) {
+        check(!decode_game(with_bits(record, INITIAL_OFFSET + 2 * 40, bits)).has_value(), "bad initial state");
+        check(!decode_game(with_bits(record, FIRST_DELTA_OFFSET + 1, bits)).has_value(), "bad old state");
+        check(!decode_game(with_bits(record, FIRST_DELTA_OFFSET + 3, bits)).has_value(), "bad new state");
+    }
+
+    // an index entry pointing past the end stops the store, which leaves no temporary file behind
+    auto archive_path = (std::filesystem::temp_directory_path() / "game_file_test.sdka").string();
+    std::filesystem::remove(archive_path);
+    GameArchive::store(archive_path, "first", sample_game());
+    GameArchive::store(archive_path, "second", sample_game());
+    check(GameArchive(archive_path).size() == 2, "stored games are listed");
+    {
+        // the offset of the first index entry, which follows the only two records
+        std::fstream file(archive_path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(24 + 2 * record.size());
+        file.put(static_cast<char>(0xFF)).put(static_cast<char>(0xFF));
+    }
+    auto is_stopped = false;
+    try {
+        GameArchive::store(archive_path, "third", sample_game());
+    } catch (const std::runtime_error&) {
+        is_stopped = true;
+    }
+    check(is_stopped, "a damaged record stops the store");
+    check(!std::filesystem::exists(archive_path + ".tmp"), "no temporary file after a failed store");
+    check(GameArchive(archive_path).size() == 2, "the old archive is unchanged");
+    std::filesystem::remove(archive_path);
+
+    return n_failures == 0 ? 0 : 1;
+}